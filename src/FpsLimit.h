@@ -14,6 +14,14 @@ struct FpsLimitFollowDraw
 };
 using FpsLimit = std::variant<FpsLimitNone, FpsLimitExplicit, FpsLimitFollowDraw>;
 
+// Simulation frames done back to back per sim tick, only the last of which gets drawn.
+// Stops early once budget milliseconds have passed, unless budget is 0.
+struct TurboMode
+{
+	int steps = 1;
+	int budget = 0;
+};
+
 struct DrawLimitDisplay
 {
 };
@@ -0,0 +1,432 @@
+#include "graphics/Renderer.h"
+#include "graphics/VideoBuffer.h"
+#include "common/String.h"
+#include "common/platform/Platform.h"
+#include "client/GameSave.h"
+#include "simulation/ElementDefs.h"
+#include "simulation/HeadlessSimulation.h"
+#include "simulation/Simulation.h"
+#include "simulation/SimulationData.h"
+#include "simulation/Snapshot.h"
+#include "Config.h"
+#include <json/json.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless batch runner. Runs saves for a number of frames on a pool of worker threads,
+// one Simulation and Renderer per job, all sharing the one SimulationData, and writes
+// the results of each job to a directory of its own:
+//
+//   result.json   frames run, time taken, final hash, periodic hashes, particle and
+//                 element counts
+//   final.cps     the simulation after the last frame
+//   final.png     and frame_NNNNNN.png every pngInterval frames, if set
+//
+// Jobs come from a manifest, a JSON object with a "jobs" array, or from stdin with
+// --control, one command per line:
+//
+//   job <JSON object>   queues a job, answered with "queued <id>"
+//   wait                answered with "idle" once all queued jobs are done
+//   quit                waits for all queued jobs, then exits, as does the end of input
+//
+// Every finished job is reported on stdout with "done <id> ok" or "done <id> failed".
+//
+// A job is a JSON object with these members:
+//
+//   save          path to the save to run, required
+//   output        directory to write results to, created if its parent exists, required
+//   frames        number of frames to run, required
+//   pngInterval   render a frame every this many frames, 0 (default) for only the last one
+//   hashInterval  record Snapshot::Hash every this many frames, 0 (default) for only the last one
+
+namespace
+{
+	struct Job
+	{
+		int id;
+		ByteString save;
+		ByteString output;
+		int frames;
+		int pngInterval;
+		int hashInterval;
+	};
+
+	std::optional<Job> ParseJob(const Json::Value &node, int id, ByteString &error)
+	{
+		if (node.type() != Json::objectValue)
+		{
+			error = "job is not an object";
+			return std::nullopt;
+		}
+		if (!node["save"].isString() || !node["output"].isString() || !node["frames"].isInt())
+		{
+			error = "job needs save, output and frames";
+			return std::nullopt;
+		}
+		Job job;
+		job.id = id;
+		job.save = node["save"].asString();
+		job.output = node["output"].asString();
+		job.frames = node["frames"].asInt();
+		job.pngInterval = node.get("pngInterval", 0).asInt();
+		job.hashInterval = node.get("hashInterval", 0).asInt();
+		if (job.frames < 0 || job.pngInterval < 0 || job.hashInterval < 0)
+		{
+			error = "frames and intervals must not be negative";
+			return std::nullopt;
+		}
+		return job;
+	}
+
+	std::optional<Json::Value> ParseJson(const char *begin, const char *end, ByteString &error)
+	{
+		Json::CharReaderBuilder rbuilder;
+		std::unique_ptr<Json::CharReader> const reader(rbuilder.newCharReader());
+		Json::Value root;
+		std::string errs;
+		if (!reader->parse(begin, end, &root, &errs))
+		{
+			error = errs;
+			return std::nullopt;
+		}
+		return root;
+	}
+
+	ByteString Hex(uint32_t value)
+	{
+		char buf[9];
+		snprintf(buf, sizeof(buf), "%08x", value);
+		return buf;
+	}
+
+	// Only stdout is shared between workers, everything else a job touches is its own.
+	std::mutex outputMx;
+
+	void Report(const ByteString &line)
+	{
+		std::lock_guard lk(outputMx);
+		std::cout << line << std::endl;
+	}
+
+	bool WritePng(Renderer &ren, const ByteString &path)
+	{
+		{
+			// * Renderers write the shared graphics cache.
+			auto &sd = SimulationData::Ref();
+			std::unique_lock lk(sd.elementGraphicsMx);
+			ren.Clear();
+			ren.RenderSimulation();
+		}
+		auto &video = ren.GetVideo();
+		auto data = VideoBuffer(video.data(), RES, video.Size().X).ToPNG();
+		return data && Platform::WriteFile(*data, path);
+	}
+
+	bool Run(const Job &job)
+	{
+		auto fail = [&job](ByteString message) {
+			std::lock_guard lk(outputMx);
+			std::cerr << "job " << job.id << ": " << message << std::endl;
+			return false;
+		};
+		auto sim = LoadHeadlessSimulation(job.save);
+		if (!sim)
+		{
+			return fail("failed to load " + job.save);
+		}
+		// * Jobs already keep every core busy, banding the air update would only oversubscribe them.
+		sim->serialBeforeSim = true;
+		if (!Platform::DirectoryExists(job.output) && !Platform::MakeDirectory(job.output))
+		{
+			return fail("failed to create " + job.output);
+		}
+		auto outputPath = [&job](ByteString name) {
+			return ByteString::Build(job.output, PATH_SEP_CHAR, name);
+		};
+		Renderer ren;
+		ren.sim = sim.get();
+		RendererSettings rendererSettings;
+		ren.ApplySettings(rendererSettings);
+		ren.ClearAccumulation();
+
+		Json::Value hashes(Json::arrayValue);
+		auto start = Platform::GetTime();
+		for (auto frame = 1; frame <= job.frames; ++frame)
+		{
+			StepHeadlessSimulation(*sim);
+			if (job.hashInterval && frame % job.hashInterval == 0)
+			{
+				Json::Value entry(Json::objectValue);
+				entry["frame"] = frame;
+				entry["hash"] = Hex(sim->CreateSnapshot()->Hash());
+				hashes.append(entry);
+			}
+			if (job.pngInterval && frame % job.pngInterval == 0)
+			{
+				if (!WritePng(ren, outputPath(ByteString::Build("frame_", Format::Width(frame, 6), ".png"))))
+				{
+					return fail("failed to write frame " + ByteString::Build(frame));
+				}
+			}
+		}
+		auto elapsed = Platform::GetTime() - start;
+
+		if (!WritePng(ren, outputPath("final.png")))
+		{
+			return fail("failed to write final.png");
+		}
+		auto [ ok, saveData ] = sim->Save(true, RES.OriginRect())->Serialise();
+		if (!ok || !Platform::WriteFile(saveData, outputPath("final.cps")))
+		{
+			return fail("failed to write final.cps");
+		}
+
+		auto &sd = SimulationData::CRef();
+		Json::Value result(Json::objectValue);
+		result["save"] = job.save;
+		result["frames"] = job.frames;
+		result["milliseconds"] = Json::UInt64(elapsed);
+		result["hash"] = Hex(sim->CreateSnapshot()->Hash());
+		result["hashes"] = hashes;
+		result["particleCount"] = sim->NUM_PARTS;
+		Json::Value elements(Json::objectValue);
+		for (auto type = 1; type < PT_NUM; ++type)
+		{
+			if (sim->elementCount[type])
+			{
+				elements[sd.elements[type].Identifier] = sim->elementCount[type];
+			}
+		}
+		result["elements"] = elements;
+		Json::StreamWriterBuilder wbuilder;
+		ByteString resultData = Json::writeString(wbuilder, result);
+		if (!Platform::WriteFile(resultData, outputPath("result.json")))
+		{
+			return fail("failed to write result.json");
+		}
+		return true;
+	}
+
+	// Hands jobs to the workers in the order they were queued.
+	class JobQueue
+	{
+		std::deque<Job> jobs;
+		int running = 0;
+		bool closed = false;
+		std::mutex mx;
+		std::condition_variable cv;
+		std::vector<std::thread> workers;
+		int failures = 0;
+
+		void Work()
+		{
+			while (true)
+			{
+				Job job;
+				{
+					std::unique_lock lk(mx);
+					cv.wait(lk, [this]() {
+						return closed || !jobs.empty();
+					});
+					if (jobs.empty())
+					{
+						return;
+					}
+					job = std::move(jobs.front());
+					jobs.pop_front();
+					running += 1;
+				}
+				auto ok = Run(job);
+				Report(ByteString::Build("done ", job.id, ok ? " ok" : " failed"));
+				{
+					std::unique_lock lk(mx);
+					running -= 1;
+					if (!ok)
+					{
+						failures += 1;
+					}
+				}
+				cv.notify_all();
+			}
+		}
+
+	public:
+		JobQueue(int workerCount)
+		{
+			for (auto i = 0; i < workerCount; ++i)
+			{
+				workers.emplace_back([this]() {
+					Work();
+				});
+			}
+		}
+
+		void Push(Job job)
+		{
+			{
+				std::unique_lock lk(mx);
+				jobs.push_back(std::move(job));
+			}
+			cv.notify_all();
+		}
+
+		void Wait()
+		{
+			std::unique_lock lk(mx);
+			cv.wait(lk, [this]() {
+				return jobs.empty() && !running;
+			});
+		}
+
+		// Waits for all jobs, returns the number of jobs that failed.
+		int Close()
+		{
+			{
+				std::unique_lock lk(mx);
+				closed = true;
+			}
+			cv.notify_all();
+			for (auto &worker : workers)
+			{
+				worker.join();
+			}
+			workers.clear();
+			return failures;
+		}
+	};
+
+	bool RunManifest(JobQueue &queue, const ByteString &path)
+	{
+		std::vector<char> data;
+		if (!Platform::ReadFile(data, path))
+		{
+			std::cerr << path << ": failed to read" << std::endl;
+			return false;
+		}
+		ByteString error;
+		auto root = ParseJson(data.data(), data.data() + data.size(), error);
+		if (!root || root->type() != Json::objectValue || !(*root)["jobs"].isArray())
+		{
+			std::cerr << path << ": not a manifest " << error << std::endl;
+			return false;
+		}
+		auto &jobs = (*root)["jobs"];
+		std::vector<Job> parsed;
+		for (auto i = 0; i < int(jobs.size()); ++i)
+		{
+			auto job = ParseJob(jobs[i], i, error);
+			if (!job)
+			{
+				std::cerr << path << ": job " << i << ": " << error << std::endl;
+				return false;
+			}
+			parsed.push_back(*job);
+		}
+		for (auto &job : parsed)
+		{
+			queue.Push(job);
+		}
+		return true;
+	}
+
+	void RunControl(JobQueue &queue)
+	{
+		auto nextID = 0;
+		std::string line;
+		while (std::getline(std::cin, line))
+		{
+			auto command = ByteString(line);
+			if (command == "quit")
+			{
+				break;
+			}
+			else if (command == "wait")
+			{
+				queue.Wait();
+				Report("idle");
+			}
+			else if (command.BeginsWith("job "))
+			{
+				ByteString error;
+				auto node = ParseJson(line.data() + 4, line.data() + line.size(), error);
+				auto job = node ? ParseJob(*node, nextID, error) : std::nullopt;
+				if (!job)
+				{
+					std::replace(error.begin(), error.end(), '\n', ' ');
+					Report("error " + error);
+					continue;
+				}
+				nextID += 1;
+				Report(ByteString::Build("queued ", job->id));
+				queue.Push(*job);
+			}
+			else if (command.size())
+			{
+				Report("error unknown command");
+			}
+		}
+	}
+
+	void Usage(const char *argv0)
+	{
+		std::cout << "Usage: " << argv0 << " [-j <workers>] <manifest>" << std::endl;
+		std::cout << "       " << argv0 << " [-j <workers>] --control" << std::endl;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	auto workerCount = std::max(1, int(std::thread::hardware_concurrency()));
+	std::optional<ByteString> manifest;
+	auto control = false;
+	for (auto i = 1; i < argc; ++i)
+	{
+		auto arg = ByteString(argv[i]);
+		if (arg == "-j" && i + 1 < argc)
+		{
+			workerCount = ByteString(argv[++i]).ToNumber<int>(true);
+		}
+		else if (arg == "--control")
+		{
+			control = true;
+		}
+		else if (!manifest)
+		{
+			manifest = arg;
+		}
+		else
+		{
+			manifest.reset();
+			break;
+		}
+	}
+	if (workerCount <= 0 || control == bool(manifest))
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+	auto simulationData = std::make_unique<SimulationData>();
+	JobQueue queue(workerCount);
+	auto ok = true;
+	if (control)
+	{
+		RunControl(queue);
+	}
+	else
+	{
+		ok = RunManifest(queue, *manifest);
+	}
+	auto failures = queue.Close();
+	return !ok ? 1 : (failures ? 2 : 0);
+}
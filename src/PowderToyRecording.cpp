@@ -0,0 +1,75 @@
+#include "common/String.h"
+#include "common/platform/Platform.h"
+#include "graphics/Recording.h"
+#include "Format.h"
+#include "Config.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Turns a recording made with tpt.record or the record key back into one image per
+// frame, named the way recordings used to be saved: frame_000000.ppm and so on.
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3 || argc > 4)
+	{
+		std::cout << "Usage: " << argv[0] << " <recording> <outputDirectory> [ppm|png]" << std::endl;
+		return 1;
+	}
+	auto inputFilename = ByteString(argv[1]);
+	auto outputDirectory = ByteString(argv[2]);
+	auto extension = ByteString(argc > 3 ? argv[3] : "ppm");
+	if (extension != "ppm" && extension != "png")
+	{
+		std::cerr << "Unknown image format " << extension << std::endl;
+		return 1;
+	}
+
+	std::vector<char> fileData;
+	if (!Platform::ReadFile(fileData, inputFilename))
+	{
+		return 1;
+	}
+	if (!Platform::DirectoryExists(outputDirectory) && !Platform::MakeDirectory(outputDirectory))
+	{
+		std::cerr << outputDirectory << ": failed to create" << std::endl;
+		return 1;
+	}
+
+	auto frameIndex = 0;
+	try
+	{
+		RecordingReader reader(fileData);
+		while (reader.Next())
+		{
+			std::vector<char> data;
+			if (extension == "png")
+			{
+				auto png = format::PixelsToPNG(reader.Frame());
+				if (!png)
+				{
+					return 1;
+				}
+				data = std::move(*png);
+			}
+			else
+			{
+				data = format::PixelsToPPM(reader.Frame());
+			}
+			auto filename = ByteString::Build(outputDirectory, PATH_SEP_CHAR, "frame_", Format::Width(frameIndex, 6), ".", extension);
+			if (!Platform::WriteFile(data, filename))
+			{
+				return 1;
+			}
+			frameIndex += 1;
+		}
+	}
+	catch (const RecordingException &e)
+	{
+		std::cerr << inputFilename << ": frame " << frameIndex << ": " << e.what() << std::endl;
+		return 1;
+	}
+	std::cout << inputFilename << ": " << frameIndex << " frames" << std::endl;
+	return 0;
+}
@@ -0,0 +1,255 @@
+#include "common/String.h"
+#include "common/platform/Platform.h"
+#include "simulation/HeadlessSimulation.h"
+#include "simulation/Simulation.h"
+#include "simulation/SimulationData.h"
+#include "simulation/Snapshot.h"
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <vector>
+
+// Golden trace recorder and checker. A trace is the Snapshot::Hash of every frame of
+// a save, plus Snapshot::SubsystemHashes, recorded by a build known to be good. Checking
+// replays the save with the current build and reports the first frame whose hash
+// differs, along with the subsystems whose hashes differ on that frame.
+//
+// Trace files are plain text, one line per frame: the frame number, the full hash,
+// then one hash per subsystem, all hex. The first line names the columns.
+
+namespace
+{
+	struct TraceSubsystem
+	{
+		ByteString name;
+		uint32_t hash;
+	};
+
+	struct TraceFrame
+	{
+		uint32_t hash;
+		std::vector<TraceSubsystem> subsystems;
+	};
+
+	struct Trace
+	{
+		std::vector<ByteString> subsystemNames;
+		std::vector<TraceFrame> frames;
+	};
+
+	TraceFrame Sample(const Simulation &sim)
+	{
+		auto snap = sim.CreateSnapshot();
+		TraceFrame frame{ snap->Hash(), {} };
+		for (auto &subsystem : snap->SubsystemHashes())
+		{
+			frame.subsystems.push_back({ subsystem.name, subsystem.hash });
+		}
+		return frame;
+	}
+
+	ByteString TracePath(const ByteString &savePath)
+	{
+		return savePath + ".trace";
+	}
+
+	ByteString Hex(uint32_t value)
+	{
+		char buf[9];
+		snprintf(buf, sizeof(buf), "%08x", value);
+		return buf;
+	}
+
+	ByteString SerializeTrace(const std::vector<TraceFrame> &frames)
+	{
+		std::ostringstream out;
+		out << "frame hash";
+		if (!frames.empty())
+		{
+			for (auto &subsystem : frames[0].subsystems)
+			{
+				out << " " << subsystem.name;
+			}
+		}
+		out << "\n";
+		for (auto i = 0; i < int(frames.size()); ++i)
+		{
+			out << i << " " << Hex(frames[i].hash);
+			for (auto &subsystem : frames[i].subsystems)
+			{
+				out << " " << Hex(subsystem.hash);
+			}
+			out << "\n";
+		}
+		return out.str();
+	}
+
+	std::optional<Trace> ParseTrace(const std::vector<char> &data)
+	{
+		std::istringstream in(std::string(data.begin(), data.end()));
+		std::string line;
+		if (!std::getline(in, line))
+		{
+			return std::nullopt;
+		}
+		Trace trace;
+		{
+			std::istringstream header(line);
+			std::string frameColumn, hashColumn, name;
+			if (!(header >> frameColumn >> hashColumn) || frameColumn != "frame" || hashColumn != "hash")
+			{
+				return std::nullopt;
+			}
+			while (header >> name)
+			{
+				trace.subsystemNames.push_back(name);
+			}
+		}
+		while (std::getline(in, line))
+		{
+			if (line.empty())
+			{
+				continue;
+			}
+			std::istringstream row(line);
+			int frame;
+			TraceFrame traceFrame;
+			if (!(row >> frame >> std::hex >> traceFrame.hash) || frame != int(trace.frames.size()))
+			{
+				return std::nullopt;
+			}
+			for (auto &name : trace.subsystemNames)
+			{
+				uint32_t hash;
+				if (!(row >> hash))
+				{
+					return std::nullopt;
+				}
+				traceFrame.subsystems.push_back({ name, hash });
+			}
+			trace.frames.push_back(std::move(traceFrame));
+		}
+		return trace;
+	}
+
+	bool Record(const ByteString &savePath, int frameCount)
+	{
+		auto sim = LoadHeadlessSimulation(savePath);
+		if (!sim)
+		{
+			return false;
+		}
+		std::vector<TraceFrame> frames;
+		frames.push_back(Sample(*sim));
+		for (auto i = 0; i < frameCount; ++i)
+		{
+			StepHeadlessSimulation(*sim);
+			frames.push_back(Sample(*sim));
+		}
+		auto data = SerializeTrace(frames);
+		if (!Platform::WriteFile(std::span(data.data(), data.size()), TracePath(savePath)))
+		{
+			std::cerr << TracePath(savePath) << ": failed to write" << std::endl;
+			return false;
+		}
+		std::cout << savePath << ": recorded " << frameCount << " frames" << std::endl;
+		return true;
+	}
+
+	bool Check(const ByteString &savePath)
+	{
+		std::vector<char> traceData;
+		if (!Platform::ReadFile(traceData, TracePath(savePath)))
+		{
+			std::cerr << TracePath(savePath) << ": failed to read" << std::endl;
+			return false;
+		}
+		auto trace = ParseTrace(traceData);
+		if (!trace || trace->frames.empty())
+		{
+			std::cerr << TracePath(savePath) << ": invalid trace" << std::endl;
+			return false;
+		}
+		auto sim = LoadHeadlessSimulation(savePath);
+		if (!sim)
+		{
+			return false;
+		}
+		for (auto frame = 0; frame < int(trace->frames.size()); ++frame)
+		{
+			if (frame)
+			{
+				StepHeadlessSimulation(*sim);
+			}
+			auto &expected = trace->frames[frame];
+			auto actual = Sample(*sim);
+			if (actual.hash == expected.hash)
+			{
+				continue;
+			}
+			std::cout << savePath << ": diverged at frame " << frame << ", expected " << Hex(expected.hash) << ", got " << Hex(actual.hash) << std::endl;
+			for (auto &expectedSubsystem : expected.subsystems)
+			{
+				for (auto &actualSubsystem : actual.subsystems)
+				{
+					if (actualSubsystem.name == expectedSubsystem.name && actualSubsystem.hash != expectedSubsystem.hash)
+					{
+						std::cout << "  " << actualSubsystem.name << ": expected " << Hex(expectedSubsystem.hash) << ", got " << Hex(actualSubsystem.hash) << std::endl;
+					}
+				}
+			}
+			return false;
+		}
+		std::cout << savePath << ": ok, " << trace->frames.size() - 1 << " frames" << std::endl;
+		return true;
+	}
+
+	void Usage(const char *argv0)
+	{
+		std::cout << "Usage: " << argv0 << " record <frames> <save>..." << std::endl;
+		std::cout << "       " << argv0 << " check <save>..." << std::endl;
+		std::cout << "Traces are read from and written to <save>.trace" << std::endl;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+	auto simulationData = std::make_unique<SimulationData>();
+	auto mode = ByteString(argv[1]);
+	auto ok = true;
+	if (mode == "record")
+	{
+		auto frameCount = ByteString(argv[2]).ToNumber<int>(true);
+		if (frameCount <= 0)
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+		for (auto i = 3; i < argc; ++i)
+		{
+			ok = Record(argv[i], frameCount) && ok;
+		}
+	}
+	else if (mode == "check")
+	{
+		for (auto i = 2; i < argc; ++i)
+		{
+			ok = Check(argv[i]) && ok;
+		}
+	}
+	else
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+	return ok ? 0 : 2;
+}
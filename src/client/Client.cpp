@@ -6,6 +6,7 @@
 #include "client/GameSave.h"
 #include "client/SaveFile.h"
 #include "client/SaveInfo.h"
+#include "client/StampIndex.h"
 #include "client/UserInfo.h"
 #include "common/platform/Platform.h"
 #include "common/String.h"
@@ -60,6 +61,7 @@ void Client::Initialize()
 
 	stamps = std::make_unique<Prefs>(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, "stamps.json"));
 	stampIDs = stamps->Get("MostRecentlyUsedFirst", std::vector<ByteString>{});
+	stampIndex = std::make_unique<StampIndex>(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, "index.json"));
 	{
 		Prefs::DeferWrite dw(*stamps);
 		if (!stamps->BackedByFile())
@@ -310,6 +312,7 @@ void Client::DeleteStamp(ByteString stampID)
 	{
 		stampIDs.erase(it, stampIDs.end());
 		Platform::RemoveFile(ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, stampID, ".stm"));
+		stampIndex->Remove(stampID);
 		WriteStamps();
 	}
 }
@@ -332,6 +335,7 @@ void Client::RenameStamp(ByteString stampID, ByteString newName)
 	}
 
 	std::replace(stampIDs.begin(), stampIDs.end(), stampID, newName);
+	stampIndex->Rename(stampID, newName);
 	WriteStamps();
 }
 
@@ -379,6 +383,7 @@ ByteString Client::AddStamp(std::unique_ptr<GameSave> saveData)
 		return "";
 
 	Platform::WriteFile(gameData, filename);
+	stampIndex->Update(saveID);
 	MoveStampToFront(saveID);
 	return saveID;
 }
@@ -418,6 +423,7 @@ void Client::RescanStamps()
 		stampIDs = newStampIDs;
 		WriteStamps();
 	}
+	stampIndexStale = true;
 }
 
 void Client::WriteStamps()
@@ -433,6 +439,16 @@ const std::vector<ByteString> &Client::GetStamps() const
 	return stampIDs;
 }
 
+const StampIndex &Client::GetStampIndex()
+{
+	if (stampIndexStale)
+	{
+		stampIndexStale = false;
+		stampIndex->Update(stampIDs);
+	}
+	return *stampIndex;
+}
+
 std::unique_ptr<SaveFile> Client::LoadSaveFile(ByteString filename)
 {
 	ByteString err;
@@ -442,10 +458,9 @@ std::unique_ptr<SaveFile> Client::LoadSaveFile(ByteString filename)
 		file = std::make_unique<SaveFile>(filename);
 		try
 		{
-			std::vector<char> data;
-			if (Platform::ReadFile(data, filename))
+			if (auto mappedFile = Platform::MapFile(filename))
 			{
-				file->SetGameSave(std::make_unique<GameSave>(std::move(data)));
+				file->SetGameSave(std::make_unique<GameSave>(mappedFile->Data()));
 			}
 			else
 			{
@@ -16,6 +16,7 @@ class GameSave;
 class VideoBuffer;
 
 class Prefs;
+class StampIndex;
 class RequestListener;
 class ClientListener;
 namespace http
@@ -62,6 +63,8 @@ private:
 	Bson authors;
 
 	std::unique_ptr<Prefs> stamps;
+	std::unique_ptr<StampIndex> stampIndex;
+	bool stampIndexStale = false; // * Stamps are only parsed once something asks for the index.
 	void MigrateStampsDef();
 	void WriteStamps();
 
@@ -110,6 +113,7 @@ public:
 	ByteString AddStamp(std::unique_ptr<GameSave> saveData);
 	void RescanStamps();
 	const std::vector<ByteString> &GetStamps() const;
+	const StampIndex &GetStampIndex();
 	void MoveStampToFront(ByteString stampID);
 
 	std::unique_ptr<SaveFile> LoadSaveFile(ByteString filename);
@@ -32,7 +32,7 @@ GameSave::GameSave(Vec2<int> newBlockSize)
 	setSize(newBlockSize);
 }
 
-GameSave::GameSave(const std::vector<char> &data, bool newWantAuthors)
+GameSave::GameSave(std::span<const char> data, bool newWantAuthors)
 {
 	wantAuthors = newWantAuthors;
 
@@ -195,7 +195,7 @@ void GameSave::MapPalette()
 	}
 }
 
-void GameSave::Expand(const std::vector<char> &data)
+void GameSave::Expand(std::span<const char> data)
 {
 	try
 	{
@@ -229,6 +229,40 @@ void GameSave::Expand(const std::vector<char> &data)
 	}
 }
 
+std::optional<GameSave::Header> GameSave::ReadHeader(std::span<const char> data)
+{
+	if (data.size() <= 15)
+	{
+		return std::nullopt;
+	}
+	auto byte = [&data](int i) {
+		return int(uint8_t(data[i]));
+	};
+	Header header;
+	if ((data[0]==0x66 && data[1]==0x75 && data[2]==0x43) || (data[0]==0x50 && data[1]==0x53 && data[2]==0x76))
+	{
+		if (byte(4) > 97) // * See readPSv.
+		{
+			return std::nullopt;
+		}
+	}
+	else if (data[0] == 'O' && data[1] == 'P' && data[2] == 'S' && data[3] == '1')
+	{
+		header.ops = true;
+	}
+	else
+	{
+		return std::nullopt;
+	}
+	header.majorVersion = byte(4);
+	header.blockSize = { byte(6), byte(7) };
+	if (byte(5) != CELL || !RectBetween({ 0, 0 }, CELLS).Contains(header.blockSize))
+	{
+		return std::nullopt;
+	}
+	return header;
+}
+
 void GameSave::setSize(Vec2<int> newBlockSize)
 {
 	blockSize = newBlockSize;
@@ -443,7 +477,7 @@ static Bson MakeOpsNonconformance()
 }
 static const Bson opsNonconformance = MakeOpsNonconformance();
 
-void GameSave::readOPS(const std::vector<char> &data)
+void GameSave::readOPS(std::span<const char> data)
 {
 	auto &builtinGol = SimulationData::builtinGol;
 
@@ -1283,7 +1317,7 @@ void GameSave::readOPS(const std::vector<char> &data)
 
 #define MTOS_EXPAND(str) #str
 #define MTOS(str) MTOS_EXPAND(str)
-void GameSave::readPSv(const std::vector<char> &dataVec)
+void GameSave::readPSv(std::span<const char> dataVec)
 {
 	auto &builtinGol = SimulationData::builtinGol;
 	Renderer::PopulateTables();
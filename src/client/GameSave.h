@@ -10,8 +10,10 @@
 #include "simulation/gravity/GravityData.h"
 #include "Misc.h"
 #include "SimulationConfig.h"
-#include <vector>
 #include <array>
+#include <optional>
+#include <span>
+#include <vector>
 
 struct sign;
 struct Particle;
@@ -60,8 +62,8 @@ public:
 class GameSave
 {
 	// number of pixels translated. When translating CELL pixels, shift all CELL grids
-	void readOPS(const std::vector<char> &data);
-	void readPSv(const std::vector<char> &data);
+	void readOPS(std::span<const char> data);
+	void readPSv(std::span<const char> data);
 	std::pair<bool, std::vector<char>> serialiseOPS() const;
 
 	void MapPalette();
@@ -127,13 +129,24 @@ public:
 	int pmapbits = 8; // default to 8 bits for older saves
 
 	GameSave(Vec2<int> newBlockSize);
-	GameSave(const std::vector<char> &data, bool newWantAuthors = true);
+	// data only needs to live as long as the constructor runs, it may be a Platform::MappedFile.
+	GameSave(std::span<const char> data, bool newWantAuthors = true);
 	void setSize(Vec2<int> newBlockSize);
 	// return value is [ fakeFromNewerVersion, gameData ]
 	std::pair<bool, std::vector<char>> Serialise() const;
 	void Transform(Mat2<int> transform, Vec2<int> nudge);
 
-	void Expand(const std::vector<char> &data);
+	void Expand(std::span<const char> data);
+
+	// What can be told about a save from its first few bytes, without decompressing the rest.
+	struct Header
+	{
+		bool ops = false; // * As opposed to the older PSv and fuC formats.
+		int majorVersion = 0;
+		Vec2<int> blockSize = { 0, 0 };
+	};
+	// std::nullopt if data doesn't start like a save that Expand would go on to decompress.
+	static std::optional<Header> ReadHeader(std::span<const char> data);
 
 	static bool PressureInTmp3(int type);
 
@@ -17,10 +17,9 @@ const GameSave *SaveFile::LazyGetGameSave() // non-owning
 	{
 		try
 		{
-			std::vector<char> data;
-			if (Platform::ReadFile(data, filename))
+			if (auto file = Platform::MapFile(filename))
 			{
-				gameSave = std::make_unique<GameSave>(std::move(data));
+				gameSave = std::make_unique<GameSave>(file->Data());
 			}
 			else
 			{
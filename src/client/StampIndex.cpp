@@ -0,0 +1,281 @@
+#include "StampIndex.h"
+#include "GameSave.h"
+#include "common/platform/Platform.h"
+#include "simulation/SimulationData.h"
+#include "Config.h"
+#include <json/json.h>
+#include <algorithm>
+#include <iostream>
+#include <set>
+
+namespace
+{
+	ByteString StampPath(const ByteString &stampID)
+	{
+		return ByteString::Build(STAMPS_DIR, PATH_SEP_CHAR, stampID, ".stm");
+	}
+}
+
+StampIndex::StampIndex(ByteString newPath) : path(newPath)
+{
+	Read();
+}
+
+void StampIndex::Read()
+{
+	std::vector<char> data;
+	if (!Platform::ReadFile(data, path) || data.empty())
+	{
+		return;
+	}
+	Json::CharReaderBuilder rbuilder;
+	std::unique_ptr<Json::CharReader> const reader(rbuilder.newCharReader());
+	Json::Value root;
+	ByteString errs;
+	if (!reader->parse(data.data(), data.data() + data.size(), &root, &errs))
+	{
+		std::cerr << errs << std::endl;
+		return;
+	}
+	if (root.type() != Json::objectValue)
+	{
+		return;
+	}
+	for (auto &stampID : root.getMemberNames())
+	{
+		auto &node = root[stampID];
+		try
+		{
+			Entry entry;
+			entry.fileSize          = node["fileSize"].asUInt64();
+			entry.fileModified      = node["fileModified"].asInt64();
+			entry.width             = node["width"].asInt();
+			entry.height            = node["height"].asInt();
+			entry.particleCount     = node["particleCount"].asInt();
+			entry.newtonianGravity  = node["newtonianGravity"].asBool();
+			entry.ambientHeat       = node["ambientHeat"].asBool();
+			entry.legacyHeat        = node["legacyHeat"].asBool();
+			entry.waterEqualisation = node["waterEqualisation"].asBool();
+			entry.airMode           = node["airMode"].asInt();
+			auto &elements = node["elements"];
+			for (auto &identifier : elements.getMemberNames())
+			{
+				entry.elements[identifier] = elements[identifier].asInt();
+			}
+			entries[stampID] = std::move(entry);
+		}
+		catch (const std::exception &)
+		{
+			// * Malformed entry, it'll get reparsed on the next Update.
+		}
+	}
+}
+
+void StampIndex::Write()
+{
+	if (!dirty)
+	{
+		return;
+	}
+	dirty = false;
+	Json::Value root(Json::objectValue);
+	for (auto &[ stampID, entry ] : entries)
+	{
+		Json::Value node(Json::objectValue);
+		node["fileSize"]          = Json::UInt64(entry.fileSize);
+		node["fileModified"]      = Json::Int64(entry.fileModified);
+		node["width"]             = entry.width;
+		node["height"]            = entry.height;
+		node["particleCount"]     = entry.particleCount;
+		node["newtonianGravity"]  = entry.newtonianGravity;
+		node["ambientHeat"]       = entry.ambientHeat;
+		node["legacyHeat"]        = entry.legacyHeat;
+		node["waterEqualisation"] = entry.waterEqualisation;
+		node["airMode"]           = entry.airMode;
+		Json::Value elements(Json::objectValue);
+		for (auto &[ identifier, count ] : entry.elements)
+		{
+			elements[identifier] = count;
+		}
+		node["elements"] = elements;
+		root[stampID] = node;
+	}
+	Json::StreamWriterBuilder wbuilder;
+	wbuilder["indentation"] = "";
+	ByteString data = Json::writeString(wbuilder, root);
+	Platform::WriteFile(data, path);
+}
+
+StampIndex::Entry StampIndex::Describe(const GameSave &save)
+{
+	auto &sd = SimulationData::CRef();
+	Entry entry;
+	entry.width             = save.blockSize.X;
+	entry.height            = save.blockSize.Y;
+	entry.newtonianGravity  = save.gravityEnable;
+	entry.ambientHeat       = save.aheatEnable;
+	entry.legacyHeat        = save.legacyEnable;
+	entry.waterEqualisation = save.waterEEnabled;
+	entry.airMode           = save.airMode;
+	std::map<int, int> counts;
+	for (auto &part : save.particles)
+	{
+		if (part.type > 0 && part.type < PT_NUM)
+		{
+			counts[part.type] += 1;
+			entry.particleCount += 1;
+		}
+	}
+	for (auto &[ type, count ] : counts)
+	{
+		entry.elements[sd.elements[type].Identifier] += count;
+	}
+	return entry;
+}
+
+void StampIndex::Refresh(const ByteString &stampID)
+{
+	auto info = Platform::GetFileInfo(StampPath(stampID));
+	if (!info)
+	{
+		if (entries.erase(stampID))
+		{
+			dirty = true;
+		}
+		return;
+	}
+	auto it = entries.find(stampID);
+	if (it != entries.end() && it->second.fileSize == info->size && it->second.fileModified == info->modified)
+	{
+		return;
+	}
+	Entry entry;
+	auto file = Platform::MapFile(StampPath(stampID));
+	// * Only the first few bytes of the mapping are read if the stamp is of a newer or unknown format.
+	if (file && GameSave::ReadHeader(file->Data()))
+	{
+		try
+		{
+			entry = Describe(GameSave(file->Data(), false));
+		}
+		catch (const ParseException &)
+		{
+			// * Keep an empty entry so that a broken stamp isn't reparsed every time.
+		}
+	}
+	entry.fileSize = info->size;
+	entry.fileModified = info->modified;
+	entries[stampID] = std::move(entry);
+	dirty = true;
+}
+
+void StampIndex::Update(const std::vector<ByteString> &stampIDs)
+{
+	std::set<ByteString> present(stampIDs.begin(), stampIDs.end());
+	for (auto it = entries.begin(); it != entries.end(); )
+	{
+		if (present.find(it->first) == present.end())
+		{
+			it = entries.erase(it);
+			dirty = true;
+		}
+		else
+		{
+			++it;
+		}
+	}
+	for (auto &stampID : stampIDs)
+	{
+		Refresh(stampID);
+	}
+	Write();
+}
+
+void StampIndex::Update(const ByteString &stampID)
+{
+	Refresh(stampID);
+	Write();
+}
+
+void StampIndex::Remove(const ByteString &stampID)
+{
+	if (entries.erase(stampID))
+	{
+		dirty = true;
+		Write();
+	}
+}
+
+void StampIndex::Rename(const ByteString &stampID, const ByteString &newStampID)
+{
+	auto it = entries.find(stampID);
+	if (it == entries.end())
+	{
+		return;
+	}
+	auto entry = std::move(it->second);
+	entries.erase(it);
+	entries[newStampID] = std::move(entry);
+	dirty = true;
+	Write();
+}
+
+const StampIndex::Entry *StampIndex::Get(const ByteString &stampID) const
+{
+	auto it = entries.find(stampID);
+	return it == entries.end() ? nullptr : &it->second;
+}
+
+bool StampIndex::Query::Matches(const Entry &entry) const
+{
+	if (newtonianGravity && *newtonianGravity != entry.newtonianGravity)
+	{
+		return false;
+	}
+	if (ambientHeat && *ambientHeat != entry.ambientHeat)
+	{
+		return false;
+	}
+	return std::all_of(elements.begin(), elements.end(), [&entry](auto &identifier) {
+		return entry.elements.find(identifier) != entry.elements.end();
+	});
+}
+
+StampIndex::Query StampIndex::Query::Parse(const ByteString &str)
+{
+	auto &sd = SimulationData::CRef();
+	Query query;
+	for (auto &word : str.PartitionBy(' '))
+	{
+		auto lower = word.ToLower();
+		if (lower == "ngrav" || lower == "-ngrav")
+		{
+			query.newtonianGravity = lower[0] != '-';
+		}
+		else if (lower == "aheat" || lower == "-aheat")
+		{
+			query.ambientHeat = lower[0] != '-';
+		}
+		else
+		{
+			auto type = sd.GetParticleType(word);
+			// * An identifier no element has, so that the query matches nothing.
+			query.elements.push_back(type > 0 ? sd.elements[type].Identifier : ByteString::Build("?", word));
+		}
+	}
+	return query;
+}
+
+std::vector<ByteString> StampIndex::Filter(const std::vector<ByteString> &stampIDs, const Query &query) const
+{
+	std::vector<ByteString> matching;
+	for (auto &stampID : stampIDs)
+	{
+		auto *entry = Get(stampID);
+		if (entry && query.Matches(*entry))
+		{
+			matching.push_back(stampID);
+		}
+	}
+	return matching;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "common/String.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+class GameSave;
+
+// Per-stamp metadata kept in STAMPS_DIR/index.json so that stamps can be filtered
+// without opening, decompressing and parsing every one of them. Entries are keyed
+// by stamp ID and are only recomputed when a stamp's size or modification time
+// changes.
+class StampIndex
+{
+public:
+	struct Entry
+	{
+		uint64_t fileSize = 0;
+		int64_t fileModified = 0;
+		int width = 0; // in blocks
+		int height = 0;
+		int particleCount = 0;
+		// Element identifiers to particle counts, identifiers rather than numbers
+		// because custom elements don't keep their numbers across sessions.
+		std::map<ByteString, int> elements;
+		bool newtonianGravity = false;
+		bool ambientHeat = false;
+		bool legacyHeat = false;
+		bool waterEqualisation = false;
+		int airMode = 0;
+	};
+
+	struct Query
+	{
+		// Stamps must contain every one of these.
+		std::vector<ByteString> elements;
+		std::optional<bool> newtonianGravity;
+		std::optional<bool> ambientHeat;
+
+		bool Matches(const Entry &entry) const;
+
+		// Space-separated element names, plus "ngrav" and "aheat" (or "-ngrav" and
+		// "-aheat") for the flags. Unknown element names match nothing.
+		static Query Parse(const ByteString &str);
+	};
+
+private:
+	std::map<ByteString, Entry> entries;
+	ByteString path;
+	bool dirty = false;
+
+	void Read();
+	void Write();
+	void Refresh(const ByteString &stampID);
+
+public:
+	StampIndex(ByteString newPath);
+
+	// Brings the index in line with the stamps on disk, reparsing only the ones
+	// whose size or modification time changed, and dropping the ones that are gone.
+	void Update(const std::vector<ByteString> &stampIDs);
+	void Update(const ByteString &stampID);
+	void Remove(const ByteString &stampID);
+	void Rename(const ByteString &stampID, const ByteString &newStampID);
+
+	const Entry *Get(const ByteString &stampID) const;
+
+	// Keeps the order of stampIDs.
+	std::vector<ByteString> Filter(const std::vector<ByteString> &stampIDs, const Query &query) const;
+
+	static Entry Describe(const GameSave &save);
+};
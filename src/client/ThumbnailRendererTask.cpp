@@ -31,10 +31,9 @@ bool ThumbnailRendererTask::doWork()
 {
 	RendererSettings rendererSettings;
 	rendererSettings.decorationLevel = decorationLevel;
-	thumbnail = SaveRenderer::Ref().Render(save.get(), fire, rendererSettings);
+	thumbnail = SaveRenderer::Ref().Render(save.get(), fire, rendererSettings, size);
 	if (thumbnail)
 	{
-		thumbnail->ResizeToFit(size, true);
 		size = thumbnail->Size();
 		return true;
 	}
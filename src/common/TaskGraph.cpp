@@ -0,0 +1,164 @@
+#include "TaskGraph.h"
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <thread>
+#include <utility>
+
+// Tasks of every graph that is being run, ready to be picked up by the workers or by
+// whichever thread is waiting in Run.
+class TaskGraph::Pool
+{
+	std::vector<std::thread> workers;
+	bool stop = false;
+
+	void Work()
+	{
+		std::unique_lock lk(mx);
+		while (true)
+		{
+			cv.wait(lk, [this]() {
+				return stop || !ready.empty();
+			});
+			if (stop)
+			{
+				return;
+			}
+			RunOne(lk);
+		}
+	}
+
+public:
+	std::mutex mx;
+	std::condition_variable cv;
+	std::deque<std::pair<TaskGraph *, TaskId>> ready;
+
+	Pool(int workerCount)
+	{
+		for (int i = 0; i < workerCount; ++i)
+		{
+			workers.emplace_back([this]() {
+				Work();
+			});
+		}
+	}
+
+	~Pool()
+	{
+		{
+			std::unique_lock lk(mx);
+			stop = true;
+		}
+		cv.notify_all();
+		for (auto &worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	void RunOne(std::unique_lock<std::mutex> &lk)
+	{
+		auto [ graph, id ] = ready.front();
+		ready.pop_front();
+		graph->RunTask(*this, lk, id);
+	}
+
+	static Pool &Ref()
+	{
+		static Pool pool(Concurrency() - 1);
+		return pool;
+	}
+};
+
+int TaskGraph::Concurrency()
+{
+	static const int concurrency = std::max(1, int(std::thread::hardware_concurrency()));
+	return concurrency;
+}
+
+TaskGraph::TaskId TaskGraph::Add(std::function<void ()> work, std::vector<TaskId> dependencies, bool callingThreadOnly)
+{
+	auto id = TaskId(tasks.size());
+	auto &task = tasks.emplace_back();
+	task.work = std::move(work);
+	task.dependencyCount = int(dependencies.size());
+	task.callingThreadOnly = callingThreadOnly;
+	for (auto dependency : dependencies)
+	{
+		assert(dependency >= 0 && dependency < id);
+		tasks[dependency].dependents.push_back(id);
+	}
+	return id;
+}
+
+void TaskGraph::MakeReady(Pool &pool, TaskId id)
+{
+	if (tasks[id].callingThreadOnly)
+	{
+		readyCallingThread.push_back(id);
+	}
+	else
+	{
+		pool.ready.push_back({ this, id });
+	}
+}
+
+void TaskGraph::RunTask(Pool &pool, std::unique_lock<std::mutex> &lk, TaskId id)
+{
+	lk.unlock();
+	tasks[id].work();
+	lk.lock();
+	for (auto dependent : tasks[id].dependents)
+	{
+		if (!--tasks[dependent].pending)
+		{
+			MakeReady(pool, dependent);
+		}
+	}
+	// * The thread in Run may return as soon as the lock is released, don't touch the graph after this.
+	remaining -= 1;
+	pool.cv.notify_all();
+}
+
+void TaskGraph::Run(bool parallel)
+{
+	if (!parallel || Concurrency() == 1)
+	{
+		for (auto &task : tasks)
+		{
+			task.work();
+		}
+		return;
+	}
+	auto &pool = Pool::Ref();
+	std::unique_lock lk(pool.mx);
+	for (int id = 0; id < int(tasks.size()); ++id)
+	{
+		tasks[id].pending = tasks[id].dependencyCount;
+		if (!tasks[id].pending)
+		{
+			MakeReady(pool, id);
+		}
+	}
+	remaining = int(tasks.size());
+	pool.cv.notify_all();
+	while (remaining)
+	{
+		if (!readyCallingThread.empty())
+		{
+			auto id = readyCallingThread.front();
+			readyCallingThread.pop_front();
+			RunTask(pool, lk, id);
+			continue;
+		}
+		// * May well be a task of another graph, which is just as good as waiting.
+		if (!pool.ready.empty())
+		{
+			pool.RunOne(lk);
+			continue;
+		}
+		pool.cv.wait(lk, [this, &pool]() {
+			return !remaining || !pool.ready.empty() || !readyCallingThread.empty();
+		});
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// A fixed set of tasks with declared dependencies, run to completion by Run. Tasks
+// are added once and the same graph can be run any number of times. Graphs don't
+// have threads of their own: all of them share one pool of workers, started the
+// first time any graph runs in parallel, so creating a graph costs nothing beyond
+// the bookkeeping. The calling thread takes part in the work while it waits, so a
+// graph with a single chain runs just as well on it alone, and so does a graph run
+// from a task of another graph.
+class TaskGraph
+{
+public:
+	using TaskId = int;
+
+private:
+	class Pool;
+
+	struct Task
+	{
+		std::function<void ()> work;
+		std::vector<TaskId> dependents;
+		int dependencyCount = 0;
+		int pending = 0;
+		bool callingThreadOnly = false;
+	};
+	std::vector<Task> tasks;
+
+	// Guarded by the pool's mutex, as are the pending counts.
+	std::deque<TaskId> readyCallingThread;
+	int remaining = 0;
+
+	void MakeReady(Pool &pool, TaskId id);
+	void RunTask(Pool &pool, std::unique_lock<std::mutex> &lk, TaskId id);
+
+public:
+	TaskGraph() = default;
+
+	TaskGraph(const TaskGraph &) = delete;
+	TaskGraph &operator =(const TaskGraph &) = delete;
+
+	// Dependencies must have been added earlier, which also makes insertion order a
+	// valid serial schedule. Tasks that may call back into code that isn't safe to run
+	// off the thread that calls Run (e.g. Lua) should set callingThreadOnly.
+	TaskId Add(std::function<void ()> work, std::vector<TaskId> dependencies = {}, bool callingThreadOnly = false);
+
+	// Runs every task once. If parallel is false, tasks run on the calling thread in
+	// insertion order, which gives the exact same sequence of operations every time.
+	void Run(bool parallel);
+
+	// Number of threads that may take part in a parallel Run, the calling one included.
+	static int Concurrency();
+};
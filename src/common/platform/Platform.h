@@ -1,6 +1,7 @@
 #pragma once
 #include "common/String.h"
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <string>
 #include <vector>
@@ -20,6 +21,15 @@ namespace Platform
 
 	bool Stat(ByteString filename);
 	bool FileExists(ByteString filename);
+	struct FileInfo
+	{
+		uint64_t size;
+		int64_t modified; // seconds since the epoch
+	};
+	/**
+	 * @return std::nullopt if filename is not a regular file
+	 */
+	std::optional<FileInfo> GetFileInfo(ByteString filename);
 	bool DirectoryExists(ByteString directory);
 	bool IsLink(ByteString path);
 	/**
@@ -43,6 +53,37 @@ namespace Platform
 	bool ReadFile(std::vector<char> &fileData, ByteString filename);
 	bool WriteFile(std::span<const char> fileData, ByteString filename);
 
+	// Read-only view of the contents of a file. Large files are mapped into memory where
+	// the platform supports it, so that only the parts actually looked at are read from
+	// disk; small ones, and all files elsewhere, are read into a buffer. A mapped file
+	// must not be truncated while the view exists, accessing the lost pages would raise
+	// SIGBUS.
+	class MappedFile
+	{
+		void *mapping = nullptr;
+		size_t mappingSize = 0;
+		std::vector<char> buffer;
+		std::span<const char> data;
+
+		friend std::unique_ptr<MappedFile> MapFile(ByteString filename);
+
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator =(const MappedFile &) = delete;
+
+		std::span<const char> Data() const
+		{
+			return data;
+		}
+	};
+	/**
+	 * @return nullptr on failure
+	 */
+	std::unique_ptr<MappedFile> MapFile(ByteString filename);
+
 	// TODO: Remove these and switch to *A Win32 API variants when we stop fully supporting windows
 	//       versions older than win10 1903, for example when win10 reaches EOL, see 18084d5aa0e5.
 	ByteString WinNarrow(const std::wstring &source);
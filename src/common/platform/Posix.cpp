@@ -1,6 +1,10 @@
 #include "Platform.h"
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <ctime>
@@ -62,6 +66,76 @@ bool FileExists(ByteString filename)
 	}
 }
 
+std::optional<FileInfo> GetFileInfo(ByteString filename)
+{
+	struct stat s;
+	if (stat(filename.c_str(), &s) != 0 || !S_ISREG(s.st_mode))
+	{
+		return std::nullopt;
+	}
+	return FileInfo{ uint64_t(s.st_size), int64_t(s.st_mtime) };
+}
+
+MappedFile::~MappedFile()
+{
+	if (mapping)
+	{
+		munmap(mapping, mappingSize);
+	}
+}
+
+// Anything smaller than this is read into a buffer rather than mapped.
+constexpr size_t mapThreshold = 4 << 20;
+
+std::unique_ptr<MappedFile> MapFile(ByteString filename)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		std::cerr << "MapFile: " << filename << ": " << strerror(errno) << std::endl;
+		return nullptr;
+	}
+	auto file = std::make_unique<MappedFile>();
+	struct stat s;
+	if (fstat(fd, &s) != 0 || !S_ISREG(s.st_mode))
+	{
+		std::cerr << "MapFile: " << filename << ": not a regular file" << std::endl;
+		close(fd);
+		return nullptr;
+	}
+	auto size = size_t(s.st_size);
+	// * Small files are copied: that costs next to nothing, and a copy doesn't turn into SIGBUS
+	//   if the file is truncated by someone else while it's being looked at. Empty files can't
+	//   be mapped, and don't need to be, either.
+	if (size < mapThreshold)
+	{
+		close(fd);
+		if (size > 0 && !ReadFile(file->buffer, filename))
+		{
+			return nullptr;
+		}
+		file->data = file->buffer;
+		return file;
+	}
+	auto *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		// * Not every file system supports mapping, fall back to reading.
+		close(fd);
+		if (!ReadFile(file->buffer, filename))
+		{
+			return nullptr;
+		}
+		file->data = file->buffer;
+		return file;
+	}
+	file->mapping = mapping;
+	file->mappingSize = size;
+	file->data = std::span(static_cast<const char *>(mapping), size);
+	close(fd);
+	return file;
+}
+
 bool DirectoryExists(ByteString directory)
 {
 	struct stat s;
@@ -76,6 +76,29 @@ bool FileExists(ByteString filename)
 	}
 }
 
+std::optional<FileInfo> GetFileInfo(ByteString filename)
+{
+	struct _stat64 s;
+	if (_wstat64(WinWiden(filename).c_str(), &s) != 0 || !(s.st_mode & _S_IFREG))
+	{
+		return std::nullopt;
+	}
+	return FileInfo{ uint64_t(s.st_size), int64_t(s.st_mtime) };
+}
+
+MappedFile::~MappedFile() = default;
+
+std::unique_ptr<MappedFile> MapFile(ByteString filename)
+{
+	auto file = std::make_unique<MappedFile>();
+	if (!ReadFile(file->buffer, filename))
+	{
+		return nullptr;
+	}
+	file->data = file->buffer;
+	return file;
+}
+
 bool DirectoryExists(ByteString directory)
 {
 	struct _stat s;
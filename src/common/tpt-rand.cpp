@@ -63,3 +63,101 @@ void RNG::seed(unsigned int sd)
 }
 
 RNG interfaceRng;
+
+/* Philox4x32-10 by John K. Salmon, Mark A. Moraes, Ron O. Dror and David E. Shaw */
+
+static inline void mulhilo(uint32_t a, uint32_t b, uint32_t &hi, uint32_t &lo)
+{
+	auto product = uint64_t(a) * uint64_t(b);
+	hi = uint32_t(product >> 32);
+	lo = uint32_t(product);
+}
+
+CounterRNG::Counter CounterRNG::Block(Counter counter, Key key)
+{
+	for (int round = 0; round < 10; ++round)
+	{
+		uint32_t hi0, lo0, hi1, lo1;
+		mulhilo(0xD2511F53U, counter[0], hi0, lo0);
+		mulhilo(0xCD9E8D57U, counter[2], hi1, lo1);
+		counter = { hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0 };
+		key[0] += 0x9E3779B9U;
+		key[1] += 0xBB67AE85U;
+	}
+	return counter;
+}
+
+CounterRNG::Key CounterRNG::KeyFromState(RNG::State state)
+{
+	auto mixed = state[0] ^ rotl(state[1], 32);
+	return { uint32_t(mixed), uint32_t(mixed >> 32) };
+}
+
+CounterRNG::CounterRNG(Key newKey, uint64_t stream, uint32_t substream) :
+	key(newKey),
+	counter{ 0U, substream, uint32_t(stream), uint32_t(stream >> 32) }
+{
+}
+
+uint32_t CounterRNG::next()
+{
+	if (used == 4)
+	{
+		block = Block(counter, key);
+		counter[0] += 1U;
+		used = 0;
+	}
+	return block[used++];
+}
+
+unsigned int CounterRNG::gen()
+{
+	return next() & 0x7FFFFFFF;
+}
+
+unsigned int CounterRNG::operator()()
+{
+	return next();
+}
+
+int CounterRNG::between(int lower, int upper)
+{
+	unsigned int r = next();
+	return static_cast<int>(r % ((unsigned int)(upper) - (unsigned int)(lower) + 1U)) + lower;
+}
+
+bool CounterRNG::chance(int numerator, unsigned int denominator)
+{
+	if (numerator < 0)
+		return false;
+	return next() % denominator < static_cast<unsigned int>(numerator);
+}
+
+float CounterRNG::uniform01()
+{
+	return static_cast<float>(next())/(float)0xFFFFFFFF;
+}
+
+void CounterRNG::uniform01(float *out, size_t count)
+{
+	size_t i = 0;
+	for (; i < count && used < 4; ++i)
+	{
+		out[i] = uniform01();
+	}
+	// * Whole blocks at a time; blocks are independent of each other, so this loop
+	//   vectorises well.
+	for (; i + 4 <= count; i += 4)
+	{
+		auto whole = Block(counter, key);
+		counter[0] += 1U;
+		for (int j = 0; j < 4; ++j)
+		{
+			out[i + j] = static_cast<float>(whole[j])/(float)0xFFFFFFFF;
+		}
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = uniform01();
+	}
+}
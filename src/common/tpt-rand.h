@@ -2,6 +2,7 @@
 #include "ExplicitSingleton.h"
 #include <stdint.h>
 #include <array>
+#include <cstddef>
 
 class RNG
 {
@@ -32,6 +33,39 @@ public:
 	}
 };
 
+// Counter-based generator (Philox4x32-10): every output is a pure function of a key and a
+// counter, so any number of streams can be drawn from independently, on any thread and in any
+// order, and still reproduce exactly. Streams are identified by a 64-bit stream number (e.g. the
+// frame) and a 32-bit substream number (e.g. a particle ID or a tile index); within a stream,
+// draws are numbered by a call counter that starts at zero.
+class CounterRNG
+{
+public:
+	using Key = std::array<uint32_t, 2>;
+	using Counter = std::array<uint32_t, 4>;
+
+	static Counter Block(Counter counter, Key key);
+	static Key KeyFromState(RNG::State state);
+
+private:
+	Key key;
+	Counter counter;
+	Counter block;
+	int used = 4;
+	uint32_t next();
+
+public:
+	CounterRNG(Key newKey, uint64_t stream, uint32_t substream);
+
+	unsigned int operator()();
+	unsigned int gen();
+	int between(int lower, int upper);
+	bool chance(int numerator, unsigned int denominator);
+	float uniform01();
+	// Same as calling uniform01 count times, but without the per-call overhead.
+	void uniform01(float *out, size_t count);
+};
+
 // Please only use this on the main thread and never for simulation stuff.
 // For simulation stuff, use Simulation::rng. For renderer stuff, use Renderer::rng.
 // For anything else, prefer a dedicated RNG instance over this one.
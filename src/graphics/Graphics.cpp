@@ -128,7 +128,11 @@ void VideoBuffer::Resize(float factor, bool resample)
 
 void VideoBuffer::ResizeToFit(Vec2<int> bound, bool resample)
 {
-	Vec2<int> size = Size();
+	Resize(SizeToFit(Size(), bound), resample);
+}
+
+Vec2<int> VideoBuffer::SizeToFit(Vec2<int> size, Vec2<int> bound)
+{
 	if (size.X > bound.X || size.Y > bound.Y)
 	{
 		auto ceilDiv = [](int a, int b) {
@@ -139,7 +143,7 @@ void VideoBuffer::ResizeToFit(Vec2<int> bound, bool resample)
 		else
 			size = { ceilDiv(size.X * bound.Y, size.Y), bound.Y };
 	}
-	Resize(size, resample);
+	return size;
 }
 
 std::unique_ptr<VideoBuffer> VideoBuffer::FromPNG(std::span<const char> data)
@@ -0,0 +1,237 @@
+#include "Recording.h"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+	constexpr char magic[] = { 'T', 'P', 'T', 'R', 'E', 'C' };
+	constexpr uint8_t version = 1;
+	constexpr int headerSize = sizeof(magic) + 5;
+	constexpr pixel colourMask = 0xFFFFFF;
+
+	void PutCount(std::vector<char> &out, uint32_t count)
+	{
+		while (count >= 0x80)
+		{
+			out.push_back(char((count & 0x7F) | 0x80));
+			count >>= 7;
+		}
+		out.push_back(char(count));
+	}
+
+	void PutUint32(std::vector<char> &out, size_t at, uint32_t value)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			out[at + i] = char(value >> (i * 8));
+		}
+	}
+
+	// Appends the runs that turn previous into current, then makes previous a copy of current.
+	void EncodeFrame(std::vector<char> &out, std::vector<pixel> &previous, const std::vector<pixel> &current)
+	{
+		auto count = int(current.size());
+		auto differs = [&previous, &current](int i) {
+			return (previous[i] ^ current[i]) & colourMask;
+		};
+		auto i = 0;
+		while (i < count)
+		{
+			auto same = i;
+			while (same < count && !differs(same))
+			{
+				same += 1;
+			}
+			auto changed = same;
+			while (changed < count && differs(changed))
+			{
+				changed += 1;
+			}
+			PutCount(out, same - i);
+			PutCount(out, changed - same);
+			for (auto j = same; j < changed; ++j)
+			{
+				auto colour = RGB::Unpack(current[j]);
+				out.push_back(char(colour.Red));
+				out.push_back(char(colour.Green));
+				out.push_back(char(colour.Blue));
+				previous[j] = current[j];
+			}
+			i = changed;
+		}
+	}
+}
+
+RecordingWriter::RecordingWriter(ByteString path, Vec2<int> newSize, int slotCount) :
+	size(newSize),
+	file(path, std::ios::binary),
+	slots(slotCount, std::vector<pixel>(newSize.X * newSize.Y))
+{
+	std::vector<char> header(magic, magic + sizeof(magic));
+	header.push_back(char(version));
+	header.push_back(char(size.X & 0xFF));
+	header.push_back(char(size.X >> 8));
+	header.push_back(char(size.Y & 0xFF));
+	header.push_back(char(size.Y >> 8));
+	file.write(header.data(), header.size());
+	if (!file)
+	{
+		std::cerr << "RecordingWriter: " << path << ": failed to create" << std::endl;
+		return;
+	}
+	writer = std::thread([this]() {
+		Write();
+	});
+}
+
+RecordingWriter::~RecordingWriter()
+{
+	if (!writer.joinable())
+	{
+		return;
+	}
+	{
+		std::unique_lock lk(mx);
+		stop = true;
+	}
+	cv.notify_all();
+	writer.join();
+}
+
+void RecordingWriter::Push(const pixel *data)
+{
+	if (!Good())
+	{
+		return;
+	}
+	int slot;
+	{
+		std::unique_lock lk(mx);
+		cv.wait(lk, [this]() {
+			return queued < int(slots.size());
+		});
+		slot = (firstQueued + queued) % int(slots.size());
+	}
+	// * The writer doesn't touch a slot until it's queued, and this is the only thread that queues.
+	std::copy(data, data + slots[slot].size(), slots[slot].begin());
+	{
+		std::unique_lock lk(mx);
+		queued += 1;
+	}
+	cv.notify_all();
+}
+
+void RecordingWriter::Write()
+{
+	std::vector<pixel> previous(size.X * size.Y, 0);
+	std::vector<char> block;
+	while (true)
+	{
+		int slot;
+		{
+			std::unique_lock lk(mx);
+			cv.wait(lk, [this]() {
+				return stop || queued;
+			});
+			if (!queued)
+			{
+				return;
+			}
+			slot = firstQueued;
+		}
+		block.assign(4, 0);
+		EncodeFrame(block, previous, slots[slot]);
+		PutUint32(block, 0, uint32_t(block.size() - 4));
+		// * Keep draining the queue even if writing fails so that Push never blocks for good.
+		file.write(block.data(), block.size());
+		{
+			std::unique_lock lk(mx);
+			firstQueued = (firstQueued + 1) % int(slots.size());
+			queued -= 1;
+		}
+		cv.notify_all();
+	}
+}
+
+RecordingReader::RecordingReader(std::span<const char> newData) : data(newData)
+{
+	if (data.size() < headerSize || !std::equal(magic, magic + sizeof(magic), data.begin()))
+	{
+		throw RecordingException("not a recording");
+	}
+	auto byte = [this](int i) {
+		return int(uint8_t(data[i]));
+	};
+	if (byte(sizeof(magic)) != version)
+	{
+		throw RecordingException("unsupported recording version");
+	}
+	auto width = byte(sizeof(magic) + 1) | (byte(sizeof(magic) + 2) << 8);
+	auto height = byte(sizeof(magic) + 3) | (byte(sizeof(magic) + 4) << 8);
+	frame = PlaneAdapter<std::vector<pixel>>({ width, height }, pixel(0));
+	pos = headerSize;
+}
+
+bool RecordingReader::Next()
+{
+	if (pos == data.size())
+	{
+		return false;
+	}
+	auto need = [this](size_t end) {
+		if (end > data.size())
+		{
+			throw RecordingException("recording cut short");
+		}
+	};
+	auto byte = [this]() {
+		return uint8_t(data[pos++]);
+	};
+	need(pos + 4);
+	uint32_t blockSize = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		blockSize |= uint32_t(byte()) << (i * 8);
+	}
+	auto end = pos + blockSize;
+	need(end);
+	auto getCount = [this, end, &byte]() {
+		uint32_t count = 0;
+		for (int shift = 0; ; shift += 7)
+		{
+			if (pos == end || shift > 28)
+			{
+				throw RecordingException("corrupt frame");
+			}
+			auto b = byte();
+			count |= uint32_t(b & 0x7F) << shift;
+			if (!(b & 0x80))
+			{
+				return count;
+			}
+		}
+	};
+	auto count = size_t(frame.Size().X) * size_t(frame.Size().Y);
+	size_t i = 0;
+	while (i < count)
+	{
+		i += getCount();
+		auto changed = getCount();
+		if (i + changed > count || pos + changed * 3 > end)
+		{
+			throw RecordingException("corrupt frame");
+		}
+		for (uint32_t j = 0; j < changed; ++j, ++i)
+		{
+			auto red = byte();
+			auto green = byte();
+			auto blue = byte();
+			frame.data()[i] = RGB(red, green, blue).Pack();
+		}
+	}
+	if (i != count || pos != end)
+	{
+		throw RecordingException("corrupt frame");
+	}
+	return true;
+}
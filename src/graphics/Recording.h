@@ -0,0 +1,85 @@
+#pragma once
+#include "Pixel.h"
+#include "common/Plane.h"
+#include "common/String.h"
+#include "common/Vec2.h"
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Frame recordings, as made by GameView while recording and turned back into images by
+// the recording converter. A recording starts with a header holding the frame size, then
+// holds one block per frame: the size of the block, then alternating runs of pixels that
+// are the same as in the previous frame (for the first frame, black) and of pixels that
+// changed, the latter followed by their colours. Consecutive frames tend to differ only
+// in a small part of the screen, so most frames come down to a few bytes.
+
+struct RecordingException : public std::runtime_error
+{
+	using runtime_error::runtime_error;
+};
+
+// Encodes frames on a thread of its own. Push hands over a copy of a frame through a
+// fixed number of slots, and only blocks if all of them are still waiting to be written.
+class RecordingWriter
+{
+	Vec2<int> size;
+	std::ofstream file;
+
+	std::vector<std::vector<pixel>> slots;
+	int firstQueued = 0;
+	int queued = 0;
+	bool stop = false;
+	std::mutex mx;
+	std::condition_variable cv;
+	std::thread writer;
+
+	void Write();
+
+public:
+	RecordingWriter(ByteString path, Vec2<int> newSize, int slotCount = 8);
+	// Writes the frames still queued before returning.
+	~RecordingWriter();
+
+	RecordingWriter(const RecordingWriter &) = delete;
+	RecordingWriter &operator =(const RecordingWriter &) = delete;
+
+	// False if the file couldn't be created, Push does nothing in that case.
+	bool Good() const
+	{
+		return writer.joinable();
+	}
+
+	// data must hold as many pixels as the frame size given to the constructor.
+	void Push(const pixel *data);
+};
+
+// Decodes a recording held in memory one frame at a time. Throws RecordingException
+// if the data is not a recording or is cut short.
+class RecordingReader
+{
+	std::span<const char> data;
+	size_t pos = 0;
+	PlaneAdapter<std::vector<pixel>> frame;
+
+public:
+	RecordingReader(std::span<const char> newData);
+
+	Vec2<int> Size() const
+	{
+		return frame.Size();
+	}
+
+	// Moves on to the next frame, false if there are no more.
+	bool Next();
+
+	const PlaneAdapter<std::vector<pixel>> &Frame() const
+	{
+		return frame;
+	}
+};
@@ -46,6 +46,83 @@ void Renderer::RenderSimulation()
 	}
 }
 
+std::unique_ptr<VideoBuffer> Renderer::RenderThumbnail(Rect<int> area, Vec2<int> size)
+{
+	area &= RES.OriginRect();
+	Clear();
+	DrawWalls();
+
+	auto &sd = SimulationData::CRef();
+	auto &elements = sd.elements;
+	GraphicsFuncContext gfctx;
+	gfctx.ren = this;
+	gfctx.sim = sim;
+	gfctx.rng.seed(rng());
+	gfctx.pipeSubcallCpart = nullptr;
+	gfctx.pipeSubcallTpart = nullptr;
+	for (auto i = 0; i < sim->parts.active; i++)
+	{
+		auto t = sim->parts[i].type;
+		if (t <= 0 || t >= PT_NUM)
+			continue;
+		auto nx = int(sim->parts[i].x + 0.5f);
+		auto ny = int(sim->parts[i].y + 0.5f);
+		if (!area.Contains({ nx, ny }))
+			continue;
+		if (TYP(sim->photons[ny][nx]) && !(elements[t].Properties & TYPE_ENERGY) && t!=PT_STKM && t!=PT_STKM2 && t!=PT_FIGH)
+			continue;
+
+		auto [ pixel_mode, cola, colr, colg, colb, firea, firer, fireg, fireb ] = GetParticleAppearance(gfctx, i, nx, ny);
+		if (pixel_mode & (PMODE_FLAT | PMODE_BLOB))
+			video[{ nx, ny }] = RGB(colr, colg, colb).Pack();
+		if (pixel_mode & (PMODE_BLEND | PMODE_BLUR))
+			BlendPixel({ nx, ny }, RGBA(colr, colg, colb, cola));
+		if (pixel_mode & (PMODE_ADD | PMODE_GLOW))
+			AddPixel({ nx, ny }, RGBA(colr, colg, colb, cola));
+		// * Fire and the like draw nothing but fire, which is skipped, so they stand in for it.
+		if (!(pixel_mode & PMODE) && (pixel_mode & FIREMODE) && firea)
+			BlendPixel({ nx, ny }, RGBA(firer, fireg, fireb, firea));
+	}
+
+	// Source columns and rows map to target columns and rows by scaling down and rounding
+	// down, so each target pixel averages one or more whole source pixels.
+	std::vector<int> targetX(area.size.X), widths(size.X, 0);
+	for (auto x = 0; x < area.size.X; x++)
+	{
+		targetX[x] = x * size.X / area.size.X;
+		widths[targetX[x]] += 1;
+	}
+	auto thumb = std::make_unique<VideoBuffer>(size);
+	std::vector<uint32_t> sums(size.X * 3, 0);
+	auto height = 0;
+	for (auto y = 0; y < area.size.Y; y++)
+	{
+		auto row = video.RowIterator(area.pos + Vec2{ 0, y });
+		for (auto x = 0; x < area.size.X; x++)
+		{
+			auto colour = RGB::Unpack(row[x]);
+			auto *sum = &sums[targetX[x] * 3];
+			sum[0] += colour.Red;
+			sum[1] += colour.Green;
+			sum[2] += colour.Blue;
+		}
+		height += 1;
+		auto ty = y * size.Y / area.size.Y;
+		if (y + 1 < area.size.Y && (y + 1) * size.Y / area.size.Y == ty)
+			continue;
+		auto *out = thumb->Data() + ty * size.X;
+		for (auto tx = 0; tx < size.X; tx++)
+		{
+			auto count = uint32_t(widths[tx] * height);
+			auto *sum = &sums[tx * 3];
+			out[tx] = RGB(sum[0] / count, sum[1] / count, sum[2] / count).Pack();
+		}
+		std::fill(sums.begin(), sums.end(), 0);
+		height = 0;
+	}
+	return thumb;
+}
+
 void Renderer::ApproximateAccumulation()
 {
 	for (int i = 0; i < 15; ++i)
@@ -238,18 +315,195 @@ void Renderer::DrawSigns()
 	}
 }
 
-void Renderer::render_parts()
+Renderer::ParticleAppearance Renderer::GetParticleAppearance(GraphicsFuncContext &gfctx, int i, int nx, int ny)
 {
 	auto &sd = SimulationData::CRef();
 	auto &elements = sd.elements;
 	auto &graphicscache = sd.graphicscache;
+	auto t = sim->parts[i].type;
+	int deca, decr, decg, decb, cola, colr, colg, colb, firea, firer, fireg, fireb, pixel_mode, q;
+
+	//Defaults
+	pixel_mode = 0 | PMODE_FLAT;
+	cola = 255;
+	RGB colour = elements[t].Colour;
+	colr = colour.Red;
+	colg = colour.Green;
+	colb = colour.Blue;
+	firer = fireg = fireb = firea = 0;
+
+	deca = (sim->parts[i].dcolour>>24)&0xFF;
+	decr = (sim->parts[i].dcolour>>16)&0xFF;
+	decg = (sim->parts[i].dcolour>>8)&0xFF;
+	decb = (sim->parts[i].dcolour)&0xFF;
+
+	if (decorationLevel == decorationAntiClickbait)
+	{
+		if(deca < 250 || decr > 5 || decg > 5 || decb > 5)
+			deca = 0;
+		else
+		{
+			deca = 255;
+			decr = decg = decb = 0;
+		}
+	}
+
+	if (graphicscache[t].isready)
+	{
+		pixel_mode = graphicscache[t].pixel_mode;
+		cola = graphicscache[t].cola;
+		colr = graphicscache[t].colr;
+		colg = graphicscache[t].colg;
+		colb = graphicscache[t].colb;
+		firea = graphicscache[t].firea;
+		firer = graphicscache[t].firer;
+		fireg = graphicscache[t].fireg;
+		fireb = graphicscache[t].fireb;
+	}
+	else if(!(colorMode & COLOUR_BASC))
+	{
+		auto *graphics = elements[t].Graphics;
+		auto makeReady = !graphics || graphics(gfctx, &(sim->parts[i]), nx, ny, &pixel_mode, &cola, &colr, &colg, &colb, &firea, &firer, &fireg, &fireb); //That's a lot of args, a struct might be better
+		if (makeReady && sim->useLuaCallbacks)
+		{
+			// useLuaCallbacks is true so we locked sd.elementGraphicsMx exclusively
+			auto &wgraphicscache = SimulationData::Ref().graphicscache;
+			wgraphicscache[t].isready = 1;
+			wgraphicscache[t].pixel_mode = pixel_mode;
+			wgraphicscache[t].cola = cola;
+			wgraphicscache[t].colr = colr;
+			wgraphicscache[t].colg = colg;
+			wgraphicscache[t].colb = colb;
+			wgraphicscache[t].firea = firea;
+			wgraphicscache[t].firer = firer;
+			wgraphicscache[t].fireg = fireg;
+			wgraphicscache[t].fireb = fireb;
+		}
+	}
+	if((elements[t].Properties & PROP_HOT_GLOW) && sim->parts[i].temp>(elements[t].HighTemperature-800.0f))
+	{
+		auto gradv = 3.1415/(2*elements[t].HighTemperature-(elements[t].HighTemperature-800.0f));
+		auto caddress = int((sim->parts[i].temp>elements[t].HighTemperature)?elements[t].HighTemperature-(elements[t].HighTemperature-800.0f):sim->parts[i].temp-(elements[t].HighTemperature-800.0f));
+		colr += int(sin(gradv*caddress) * 226);
+		colg += int(sin(gradv*caddress*4.55 +TPT_PI_DBL) * 34);
+		colb += int(sin(gradv*caddress*2.22 +TPT_PI_DBL) * 64);
+	}
+
+	if((pixel_mode & FIRE_ADD) && !(renderMode & FIRE_ADD))
+		pixel_mode |= PMODE_GLOW;
+	if((pixel_mode & FIRE_BLEND) && !(renderMode & FIRE_BLEND))
+		pixel_mode |= PMODE_BLUR;
+	if((pixel_mode & PMODE_BLUR) && !(renderMode & PMODE_BLUR))
+		pixel_mode |= PMODE_FLAT;
+	if((pixel_mode & PMODE_GLOW) && !(renderMode & PMODE_GLOW))
+		pixel_mode |= PMODE_BLEND;
+	if (renderMode & PMODE_BLOB)
+		pixel_mode |= PMODE_BLOB;
+
+	pixel_mode &= renderMode;
+
+	//Alter colour based on display mode
+	if(colorMode & COLOUR_HEAT)
+	{
+		firea = 255;
+		RGB color = heatTableAt(int((sim->parts[i].temp - stats.hdispLimitMin) / (stats.hdispLimitMax - stats.hdispLimitMin) * 1024));
+		firer = colr = color.Red;
+		fireg = colg = color.Green;
+		fireb = colb = color.Blue;
+		cola = 255;
+		if(pixel_mode & (FIREMODE | PMODE_GLOW))
+			pixel_mode = (pixel_mode & ~(FIREMODE|PMODE_GLOW)) | PMODE_BLUR;
+		else if ((pixel_mode & (PMODE_BLEND | PMODE_ADD)) == (PMODE_BLEND | PMODE_ADD))
+			pixel_mode = (pixel_mode & ~(PMODE_BLEND|PMODE_ADD)) | PMODE_FLAT;
+		else if (!pixel_mode)
+			pixel_mode |= PMODE_FLAT;
+	}
+	else if(colorMode & COLOUR_LIFE)
+	{
+		auto gradv = 0.4f;
+		if (!(sim->parts[i].life<5))
+			q = int(sqrt((float)sim->parts[i].life));
+		else
+			q = sim->parts[i].life;
+		colr = colg = colb = int(sin(gradv*q) * 100 + 128);
+		cola = 255;
+		if(pixel_mode & (FIREMODE | PMODE_GLOW))
+			pixel_mode = (pixel_mode & ~(FIREMODE|PMODE_GLOW)) | PMODE_BLUR;
+		else if ((pixel_mode & (PMODE_BLEND | PMODE_ADD)) == (PMODE_BLEND | PMODE_ADD))
+			pixel_mode = (pixel_mode & ~(PMODE_BLEND|PMODE_ADD)) | PMODE_FLAT;
+		else if (!pixel_mode)
+			pixel_mode |= PMODE_FLAT;
+	}
+	else if(colorMode & COLOUR_BASC)
+	{
+		colr = colour.Red;
+		colg = colour.Green;
+		colb = colour.Blue;
+		pixel_mode = PMODE_FLAT;
+	}
+
+	//Apply decoration colour
+	if(!(colorMode & ~COLOUR_GRAD) && decorationLevel != decorationDisabled && deca)
+	{
+		deca++;
+		if(!(pixel_mode & NO_DECO))
+		{
+			colr = (deca*decr + (256-deca)*colr) >> 8;
+			colg = (deca*decg + (256-deca)*colg) >> 8;
+			colb = (deca*decb + (256-deca)*colb) >> 8;
+		}
+
+		if(pixel_mode & DECO_FIRE)
+		{
+			firer = (deca*decr + (256-deca)*firer) >> 8;
+			fireg = (deca*decg + (256-deca)*fireg) >> 8;
+			fireb = (deca*decb + (256-deca)*fireb) >> 8;
+		}
+	}
+
+	if (colorMode & COLOUR_GRAD)
+	{
+		auto frequency = 0.05f;
+		auto q = int(sim->parts[i].temp-40);
+		colr = int(sin(frequency*q) * 16 + colr);
+		colg = int(sin(frequency*q) * 16 + colg);
+		colb = int(sin(frequency*q) * 16 + colb);
+		if(pixel_mode & (FIREMODE | PMODE_GLOW)) pixel_mode = (pixel_mode & ~(FIREMODE|PMODE_GLOW)) | PMODE_BLUR;
+	}
+
+	//All colours are now set, check ranges
+	if(colr>255) colr = 255;
+	else if(colr<0) colr = 0;
+	if(colg>255) colg = 255;
+	else if(colg<0) colg = 0;
+	if(colb>255) colb = 255;
+	else if(colb<0) colb = 0;
+	if(cola>255) cola = 255;
+	else if(cola<0) cola = 0;
+
+	if(firer>255) firer = 255;
+	else if(firer<0) firer = 0;
+	if(fireg>255) fireg = 255;
+	else if(fireg<0) fireg = 0;
+	if(fireb>255) fireb = 255;
+	else if(fireb<0) fireb = 0;
+	if(firea>255) firea = 255;
+	else if(firea<0) firea = 0;
+
+	return { pixel_mode, cola, colr, colg, colb, firea, firer, fireg, fireb };
+}
+
+void Renderer::render_parts()
+{
+	auto &sd = SimulationData::CRef();
+	auto &elements = sd.elements;
 	GraphicsFuncContext gfctx;
 	gfctx.ren = this;
 	gfctx.sim = sim;
 	gfctx.rng.seed(rng());
 	gfctx.pipeSubcallCpart = nullptr;
 	gfctx.pipeSubcallTpart = nullptr;
-	int deca, decr, decg, decb, cola, colr, colg, colb, firea, firer, fireg, fireb, pixel_mode, q, i, t, nx, ny, x, y;
+	int i, t, nx, ny, x, y;
 	int orbd[4] = {0, 0, 0, 0}, orbl[4] = {0, 0, 0, 0};
 	int drawing_budget = 1000000; //Serves as an upper bound for costly effects such as SPARK, FLARE and LFLARE
 
@@ -278,174 +532,8 @@ void Renderer::render_parts()
 			if(TYP(sim->photons[ny][nx]) && !(elements[t].Properties & TYPE_ENERGY) && t!=PT_STKM && t!=PT_STKM2 && t!=PT_FIGH)
 				continue;
 
-			//Defaults
-			pixel_mode = 0 | PMODE_FLAT;
-			cola = 255;
-			RGB colour = elements[t].Colour;
-			colr = colour.Red;
-			colg = colour.Green;
-			colb = colour.Blue;
-			firer = fireg = fireb = firea = 0;
-
-			deca = (sim->parts[i].dcolour>>24)&0xFF;
-			decr = (sim->parts[i].dcolour>>16)&0xFF;
-			decg = (sim->parts[i].dcolour>>8)&0xFF;
-			decb = (sim->parts[i].dcolour)&0xFF;
-
-			if (decorationLevel == decorationAntiClickbait)
-			{
-				if(deca < 250 || decr > 5 || decg > 5 || decb > 5)
-					deca = 0;
-				else
-				{
-					deca = 255;
-					decr = decg = decb = 0;
-				}
-			}
-
+			auto [ pixel_mode, cola, colr, colg, colb, firea, firer, fireg, fireb ] = GetParticleAppearance(gfctx, i, nx, ny);
 			{
-				if (graphicscache[t].isready)
-				{
-					pixel_mode = graphicscache[t].pixel_mode;
-					cola = graphicscache[t].cola;
-					colr = graphicscache[t].colr;
-					colg = graphicscache[t].colg;
-					colb = graphicscache[t].colb;
-					firea = graphicscache[t].firea;
-					firer = graphicscache[t].firer;
-					fireg = graphicscache[t].fireg;
-					fireb = graphicscache[t].fireb;
-				}
-				else if(!(colorMode & COLOUR_BASC))
-				{
-					auto *graphics = elements[t].Graphics;
-					auto makeReady = !graphics || graphics(gfctx, &(sim->parts[i]), nx, ny, &pixel_mode, &cola, &colr, &colg, &colb, &firea, &firer, &fireg, &fireb); //That's a lot of args, a struct might be better
-					if (makeReady && sim->useLuaCallbacks)
-					{
-						// useLuaCallbacks is true so we locked sd.elementGraphicsMx exclusively
-						auto &wgraphicscache = SimulationData::Ref().graphicscache;
-						wgraphicscache[t].isready = 1;
-						wgraphicscache[t].pixel_mode = pixel_mode;
-						wgraphicscache[t].cola = cola;
-						wgraphicscache[t].colr = colr;
-						wgraphicscache[t].colg = colg;
-						wgraphicscache[t].colb = colb;
-						wgraphicscache[t].firea = firea;
-						wgraphicscache[t].firer = firer;
-						wgraphicscache[t].fireg = fireg;
-						wgraphicscache[t].fireb = fireb;
-					}
-				}
-				if((elements[t].Properties & PROP_HOT_GLOW) && sim->parts[i].temp>(elements[t].HighTemperature-800.0f))
-				{
-					auto gradv = 3.1415/(2*elements[t].HighTemperature-(elements[t].HighTemperature-800.0f));
-					auto caddress = int((sim->parts[i].temp>elements[t].HighTemperature)?elements[t].HighTemperature-(elements[t].HighTemperature-800.0f):sim->parts[i].temp-(elements[t].HighTemperature-800.0f));
-					colr += int(sin(gradv*caddress) * 226);
-					colg += int(sin(gradv*caddress*4.55 +TPT_PI_DBL) * 34);
-					colb += int(sin(gradv*caddress*2.22 +TPT_PI_DBL) * 64);
-				}
-
-				if((pixel_mode & FIRE_ADD) && !(renderMode & FIRE_ADD))
-					pixel_mode |= PMODE_GLOW;
-				if((pixel_mode & FIRE_BLEND) && !(renderMode & FIRE_BLEND))
-					pixel_mode |= PMODE_BLUR;
-				if((pixel_mode & PMODE_BLUR) && !(renderMode & PMODE_BLUR))
-					pixel_mode |= PMODE_FLAT;
-				if((pixel_mode & PMODE_GLOW) && !(renderMode & PMODE_GLOW))
-					pixel_mode |= PMODE_BLEND;
-				if (renderMode & PMODE_BLOB)
-					pixel_mode |= PMODE_BLOB;
-
-				pixel_mode &= renderMode;
-
-				//Alter colour based on display mode
-				if(colorMode & COLOUR_HEAT)
-				{
-					firea = 255;
-					RGB color = heatTableAt(int((sim->parts[i].temp - stats.hdispLimitMin) / (stats.hdispLimitMax - stats.hdispLimitMin) * 1024));
-					firer = colr = color.Red;
-					fireg = colg = color.Green;
-					fireb = colb = color.Blue;
-					cola = 255;
-					if(pixel_mode & (FIREMODE | PMODE_GLOW))
-						pixel_mode = (pixel_mode & ~(FIREMODE|PMODE_GLOW)) | PMODE_BLUR;
-					else if ((pixel_mode & (PMODE_BLEND | PMODE_ADD)) == (PMODE_BLEND | PMODE_ADD))
-						pixel_mode = (pixel_mode & ~(PMODE_BLEND|PMODE_ADD)) | PMODE_FLAT;
-					else if (!pixel_mode)
-						pixel_mode |= PMODE_FLAT;
-				}
-				else if(colorMode & COLOUR_LIFE)
-				{
-					auto gradv = 0.4f;
-					if (!(sim->parts[i].life<5))
-						q = int(sqrt((float)sim->parts[i].life));
-					else
-						q = sim->parts[i].life;
-					colr = colg = colb = int(sin(gradv*q) * 100 + 128);
-					cola = 255;
-					if(pixel_mode & (FIREMODE | PMODE_GLOW))
-						pixel_mode = (pixel_mode & ~(FIREMODE|PMODE_GLOW)) | PMODE_BLUR;
-					else if ((pixel_mode & (PMODE_BLEND | PMODE_ADD)) == (PMODE_BLEND | PMODE_ADD))
-						pixel_mode = (pixel_mode & ~(PMODE_BLEND|PMODE_ADD)) | PMODE_FLAT;
-					else if (!pixel_mode)
-						pixel_mode |= PMODE_FLAT;
-				}
-				else if(colorMode & COLOUR_BASC)
-				{
-					colr = colour.Red;
-					colg = colour.Green;
-					colb = colour.Blue;
-					pixel_mode = PMODE_FLAT;
-				}
-
-				//Apply decoration colour
-				if(!(colorMode & ~COLOUR_GRAD) && decorationLevel != decorationDisabled && deca)
-				{
-					deca++;
-					if(!(pixel_mode & NO_DECO))
-					{
-						colr = (deca*decr + (256-deca)*colr) >> 8;
-						colg = (deca*decg + (256-deca)*colg) >> 8;
-						colb = (deca*decb + (256-deca)*colb) >> 8;
-					}
-
-					if(pixel_mode & DECO_FIRE)
-					{
-						firer = (deca*decr + (256-deca)*firer) >> 8;
-						fireg = (deca*decg + (256-deca)*fireg) >> 8;
-						fireb = (deca*decb + (256-deca)*fireb) >> 8;
-					}
-				}
-
-				if (colorMode & COLOUR_GRAD)
-				{
-					auto frequency = 0.05f;
-					auto q = int(sim->parts[i].temp-40);
-					colr = int(sin(frequency*q) * 16 + colr);
-					colg = int(sin(frequency*q) * 16 + colg);
-					colb = int(sin(frequency*q) * 16 + colb);
-					if(pixel_mode & (FIREMODE | PMODE_GLOW)) pixel_mode = (pixel_mode & ~(FIREMODE|PMODE_GLOW)) | PMODE_BLUR;
-				}
-
-				//All colours are now set, check ranges
-				if(colr>255) colr = 255;
-				else if(colr<0) colr = 0;
-				if(colg>255) colg = 255;
-				else if(colg<0) colg = 0;
-				if(colb>255) colb = 255;
-				else if(colb<0) colb = 0;
-				if(cola>255) cola = 255;
-				else if(cola<0) cola = 0;
-
-				if(firer>255) firer = 255;
-				else if(firer<0) firer = 0;
-				if(fireg>255) fireg = 255;
-				else if(fireg<0) fireg = 0;
-				if(fireb>255) fireb = 255;
-				else if(fireb<0) fireb = 0;
-				if(firea>255) firea = 255;
-				else if(firea<0) firea = 0;
-
 				auto matchesFindingElement = false;
 				if (findingElement)
 				{
@@ -47,6 +47,15 @@ class Renderer : private RendererSettings, public RasterDrawMethods<Renderer>
 	unsigned char fire_b[YCELLS][XCELLS];
 	unsigned int fire_alpha[CELL*3][CELL*3];
 
+	struct ParticleAppearance
+	{
+		int pixelMode;
+		int cola, colr, colg, colb;
+		int firea, firer, fireg, fireb;
+	};
+	// What render_parts draws particle i at (nx, ny) with, save for the tinting done while finding elements.
+	ParticleAppearance GetParticleAppearance(GraphicsFuncContext &gfctx, int i, int nx, int ny);
+
 	void DrawBlob(Vec2<int> pos, RGB colour);
 	void DrawWalls();
 	void DrawSigns();
@@ -65,6 +74,11 @@ public:
 	Renderer();
 	void ApplySettings(const RendererSettings &newSettings);
 	void RenderSimulation();
+	// Cheaper alternative to RenderSimulation followed by scaling the result down, for
+	// thumbnails: draws walls and particles one pixel each, without glow, blur, fire, signs
+	// and other effects that hardly show at such sizes, and box filters area of the result
+	// straight into an image of the given size, which must not be larger than area.
+	std::unique_ptr<VideoBuffer> RenderThumbnail(Rect<int> area, Vec2<int> size);
 	void RenderBackground();
 	void ApproximateAccumulation();
 	void ClearAccumulation();
@@ -53,6 +53,8 @@ public:
 	void Resize(Vec2<int> size, bool resample = false);
 	// Automatically choose a size to fit within the given box, keeping aspect ratio
 	void ResizeToFit(Vec2<int> bound, bool resample = false);
+	// The size ResizeToFit would choose for an image of the given size
+	static Vec2<int> SizeToFit(Vec2<int> size, Vec2<int> bound);
 
 	static std::unique_ptr<VideoBuffer> FromPNG(std::span<const char> data);
 	std::unique_ptr<std::vector<char>> ToPNG() const;
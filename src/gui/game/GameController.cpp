@@ -346,62 +346,77 @@ ui::Point GameController::NormaliseBlockCoord(ui::Point point)
 	return (point/CELL)*CELL;
 }
 
+// The Draw* and Tool* functions below are called while the mouse moves, so they don't wait
+// for the step running on the simulation thread, if any, see GameModel::QueueSimulationCommand.
 void GameController::DrawRect(int toolSelection, ui::Point point1, ui::Point point2)
 {
-	Simulation * sim = gameModel->GetSimulation();
-	Tool * activeTool = gameModel->GetActiveTool(toolSelection);
-	gameModel->SetLastTool(activeTool);
-	Brush &cBrush = gameModel->GetBrush();
-	if (!activeTool)
-		return;
-	activeTool->Strength = 1.0f;
-	activeTool->DrawRect(sim, cBrush, point1, point2);
+	gameModel->QueueSimulationCommand([this, toolSelection, point1, point2]() {
+		Simulation * sim = gameModel->GetSimulation();
+		Tool * activeTool = gameModel->GetActiveTool(toolSelection);
+		gameModel->SetLastTool(activeTool);
+		Brush &cBrush = gameModel->GetBrush();
+		if (!activeTool)
+			return;
+		activeTool->Strength = 1.0f;
+		activeTool->DrawRect(sim, cBrush, point1, point2);
+	});
 }
 
 void GameController::DrawLine(int toolSelection, ui::Point point1, ui::Point point2)
 {
-	Simulation * sim = gameModel->GetSimulation();
-	Tool * activeTool = gameModel->GetActiveTool(toolSelection);
-	gameModel->SetLastTool(activeTool);
-	Brush &cBrush = gameModel->GetBrush();
-	if (!activeTool)
-		return;
-	activeTool->Strength = 1.0f;
-	activeTool->DrawLine(sim, cBrush, point1, point2, false);
+	gameModel->QueueSimulationCommand([this, toolSelection, point1, point2]() {
+		Simulation * sim = gameModel->GetSimulation();
+		Tool * activeTool = gameModel->GetActiveTool(toolSelection);
+		gameModel->SetLastTool(activeTool);
+		Brush &cBrush = gameModel->GetBrush();
+		if (!activeTool)
+			return;
+		activeTool->Strength = 1.0f;
+		activeTool->DrawLine(sim, cBrush, point1, point2, false);
+	});
 }
 
 void GameController::DrawFill(int toolSelection, ui::Point point)
 {
-	Simulation * sim = gameModel->GetSimulation();
-	Tool * activeTool = gameModel->GetActiveTool(toolSelection);
-	gameModel->SetLastTool(activeTool);
-	Brush &cBrush = gameModel->GetBrush();
-	if (!activeTool)
-		return;
-	activeTool->Strength = 1.0f;
-	activeTool->DrawFill(sim, cBrush, point);
+	gameModel->QueueSimulationCommand([this, toolSelection, point]() {
+		Simulation * sim = gameModel->GetSimulation();
+		Tool * activeTool = gameModel->GetActiveTool(toolSelection);
+		gameModel->SetLastTool(activeTool);
+		Brush &cBrush = gameModel->GetBrush();
+		if (!activeTool)
+			return;
+		activeTool->Strength = 1.0f;
+		activeTool->DrawFill(sim, cBrush, point);
+	});
 }
 
 void GameController::DrawPoints(int toolSelection, ui::Point oldPos, ui::Point newPos, bool held)
 {
-	Simulation * sim = gameModel->GetSimulation();
-	Tool * activeTool = gameModel->GetActiveTool(toolSelection);
-	gameModel->SetLastTool(activeTool);
-	Brush &cBrush = gameModel->GetBrush();
-	if (!activeTool)
-	{
-		return;
-	}
+	// * Taken now rather than when the command runs, the keys may have been released by then.
+	auto strength = gameModel->GetToolStrength();
+	auto shiftBehaviour = gameView->ShiftBehaviour();
+	auto ctrlBehaviour = gameView->CtrlBehaviour();
+	auto altBehaviour = gameView->AltBehaviour();
+	gameModel->QueueSimulationCommand([this, toolSelection, oldPos, newPos, held, strength, shiftBehaviour, ctrlBehaviour, altBehaviour]() {
+		Simulation * sim = gameModel->GetSimulation();
+		Tool * activeTool = gameModel->GetActiveTool(toolSelection);
+		gameModel->SetLastTool(activeTool);
+		Brush &cBrush = gameModel->GetBrush();
+		if (!activeTool)
+		{
+			return;
+		}
 
-	activeTool->Strength = gameModel->GetToolStrength();
-	// This is a joke, the game mvc has to go >_>
-	activeTool->shiftBehaviour = gameView->ShiftBehaviour();
-	activeTool->ctrlBehaviour = gameView->CtrlBehaviour();
-	activeTool->altBehaviour = gameView->AltBehaviour();
-	if (!held)
-		activeTool->Draw(sim, cBrush, newPos);
-	else
-		activeTool->DrawLine(sim, cBrush, oldPos, newPos, true);
+		activeTool->Strength = strength;
+		// This is a joke, the game mvc has to go >_>
+		activeTool->shiftBehaviour = shiftBehaviour;
+		activeTool->ctrlBehaviour = ctrlBehaviour;
+		activeTool->altBehaviour = altBehaviour;
+		if (!held)
+			activeTool->Draw(sim, cBrush, newPos);
+		else
+			activeTool->DrawLine(sim, cBrush, oldPos, newPos, true);
+	});
 }
 
 bool GameController::LoadClipboard()
@@ -425,22 +440,26 @@ void GameController::TransformPlaceSave(Mat2<int> transform, Vec2<int> nudge)
 
 void GameController::ToolClick(int toolSelection, ui::Point point)
 {
-	Simulation * sim = gameModel->GetSimulation();
-	Tool * activeTool = gameModel->GetActiveTool(toolSelection);
-	Brush &cBrush = gameModel->GetBrush();
-	if (!activeTool)
-		return;
-	activeTool->Click(sim, cBrush, point);
+	gameModel->QueueSimulationCommand([this, toolSelection, point]() {
+		Simulation * sim = gameModel->GetSimulation();
+		Tool * activeTool = gameModel->GetActiveTool(toolSelection);
+		Brush &cBrush = gameModel->GetBrush();
+		if (!activeTool)
+			return;
+		activeTool->Click(sim, cBrush, point);
+	});
 }
 
 void GameController::ToolDrag(int toolSelection, ui::Point point1, ui::Point point2)
 {
-	Simulation * sim = gameModel->GetSimulation();
-	Tool * activeTool = gameModel->GetActiveTool(toolSelection);
-	Brush &cBrush = gameModel->GetBrush();
-	if (!activeTool)
-		return;
-	activeTool->Drag(sim, cBrush, point1, point2);
+	gameModel->QueueSimulationCommand([this, toolSelection, point1, point2]() {
+		Simulation * sim = gameModel->GetSimulation();
+		Tool * activeTool = gameModel->GetActiveTool(toolSelection);
+		Brush &cBrush = gameModel->GetBrush();
+		if (!activeTool)
+			return;
+		activeTool->Drag(sim, cBrush, point1, point2);
+	});
 }
 
 static Rect<int> SaneSaveRect(Vec2<int> point1, Vec2<int> point2)
@@ -753,6 +772,8 @@ void GameController::Tick()
 
 void GameController::Blur()
 {
+	// * Whatever window comes next may well touch the simulation.
+	gameModel->FinishSimulationStep();
 	// Tell lua that mouse is up (even if it really isn't)
 	MouseUp(0, 0, 0, mouseUpBlur);
 	commandInterface->HandleEvent(BlurEvent{});
@@ -894,7 +915,7 @@ void GameController::Update()
 	Simulation * sim = gameModel->GetSimulation();
 	if (gameModel->IsSimRunning())
 	{
-		gameModel->UpdateUpTo(NPART);
+		gameModel->StepSimulation(ThreadedSimulationAllowed());
 	}
 	else
 	{
@@ -1753,6 +1774,21 @@ bool GameController::ThreadedRenderingAllowed()
 	return gameModel->GetThreadedRendering() && !GetPaused() && !commandInterface->HaveSimGraphicsEventHandlers();
 }
 
+bool GameController::ThreadedSimulationAllowed()
+{
+	return gameModel->GetThreadedSimulation() && !GetPaused() && !commandInterface->HaveSimulationCallbacks();
+}
+
+void GameController::DispatchSimulationStep()
+{
+	gameModel->DispatchSimulationStep();
+}
+
+void GameController::FinishSimulationStep()
+{
+	gameModel->FinishSimulationStep();
+}
+
 void GameController::SetToolIndex(ByteString identifier, std::optional<int> index)
 {
 	if (commandInterface)
@@ -215,6 +215,9 @@ public:
 	void BeforeSimDraw();
 	void AfterSimDraw();
 	bool ThreadedRenderingAllowed();
+	bool ThreadedSimulationAllowed();
+	void DispatchSimulationStep();
+	void FinishSimulationStep();
 
 	void SetToolIndex(ByteString identifier, std::optional<int> index);
 	void InitCommandInterface();
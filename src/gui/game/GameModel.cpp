@@ -108,6 +108,7 @@ GameModel::GameModel(GameView *newView):
 	rendererSettings.gravityFieldEnabled = prefs.Get("Renderer.GravityField", false);
 	rendererSettings.decorationLevel = prefs.Get("Renderer.Decorations", true) ? RendererSettings::decorationEnabled : RendererSettings::decorationDisabled;
 	threadedRendering = prefs.Get("Renderer.SeparateThread", true);
+	threadedSimulation = prefs.Get("Simulation.SeparateThread", false);
 
 	//Load config into simulation
 	edgeMode = prefs.Get("Simulation.EdgeMode", NUM_EDGEMODES, EDGE_VOID);
@@ -188,6 +189,8 @@ GameModel::GameModel(GameView *newView):
 
 GameModel::~GameModel()
 {
+	FinishSimulationStep();
+	StopSimulationThread();
 	auto &prefs = GlobalPrefs::Ref();
 	{
 		//Save to config:
@@ -313,6 +316,11 @@ void GameModel::SetThreadedRendering(bool newThreadedRendering)
 	threadedRendering = newThreadedRendering;
 }
 
+void GameModel::SetThreadedSimulation(bool newThreadedSimulation)
+{
+	threadedSimulation = newThreadedSimulation;
+}
+
 void GameModel::SetAmbientAirTemperature(float ambientAirTemp)
 {
 	this->ambientAirTemp = ambientAirTemp;
@@ -855,6 +863,7 @@ void GameModel::SetSaveFile(std::unique_ptr<SaveFile> newSave, bool invertInclud
 
 Simulation * GameModel::GetSimulation()
 {
+	FinishSimulationStep();
 	return sim;
 }
 
@@ -1616,6 +1625,7 @@ std::optional<CustomGOLData> GameModel::CheckCustomGol(String ruleString, String
 
 void GameModel::UpdateUpTo(int upTo)
 {
+	FinishSimulationStep();
 	if (upTo < sim->debug_nextToUpdate)
 	{
 		upTo = NPART;
@@ -1647,15 +1657,158 @@ void GameModel::BeforeSim()
 	{
 		CommandInterface::Ref().HandleEvent(BeforeSimEvent{});
 	}
+	sim->haveLuaElementCallbacks = CommandInterface::Ref().HaveSimulationCallbacks();
 	sim->BeforeSim(willUpdate);
 }
 
 void GameModel::AfterSim()
 {
+	CommandInterface::Ref().FlushCustomElementBatches();
 	sim->AfterSim();
 	CommandInterface::Ref().HandleEvent(AfterSimEvent{});
 }
 
+void GameModel::StepSimulation(bool threaded)
+{
+	if (simulationStepQueued)
+	{
+		// * Nothing was drawn since the last step was queued, so it never got dispatched.
+		simulationStepQueued = false;
+		UpdateUpTo(NPART);
+	}
+	if (threaded && sim->debug_nextToUpdate == 0)
+	{
+		simulationStepQueued = true;
+		return;
+	}
+	UpdateUpTo(NPART);
+}
+
+void GameModel::DispatchSimulationStep()
+{
+	if (!simulationStepQueued)
+	{
+		return;
+	}
+	simulationStepQueued = false;
+	if (!IsSimRunning())
+	{
+		// * Paused since the step was queued.
+		return;
+	}
+	if (sim->debug_nextToUpdate != 0)
+	{
+		// * Partially updated since the step was queued, see ParticleDebug.
+		UpdateUpTo(NPART);
+		return;
+	}
+	BeforeSim();
+	if (CommandInterface::Ref().HaveSimulationCallbacks())
+	{
+		// * Tick or BeforeSim handlers registered element callbacks since the step was queued,
+		//   and UpdateParticles may only call those on this thread.
+		sim->UpdateParticles(0, NPART);
+		if (queuedFrames)
+		{
+			queuedFrames--;
+		}
+		AfterSim();
+		return;
+	}
+	if (simulationThreadState == simulationThreadAbsent)
+	{
+		simulationThreadState = simulationThreadRunning;
+		simulationThread = std::thread([this]() {
+			SimulationThread();
+		});
+	}
+	{
+		std::lock_guard lk(simulationThreadMx);
+		simulationThreadOwnsSimulation = true;
+	}
+	simulationStepRunning = true;
+	simulationThreadCv.notify_all();
+}
+
+void GameModel::FinishSimulationStep()
+{
+	if (!simulationStepRunning)
+	{
+		return;
+	}
+	{
+		std::unique_lock lk(simulationThreadMx);
+		simulationThreadCv.wait(lk, [this]() {
+			return !simulationThreadOwnsSimulation;
+		});
+	}
+	// * Cleared before AfterSim so that Lua code called from there, which gets here
+	//   through GetSimulation, doesn't wait for itself.
+	simulationStepRunning = false;
+	if (queuedFrames)
+	{
+		queuedFrames--;
+	}
+	AfterSim();
+	auto commands = std::move(simulationCommands);
+	simulationCommands.clear();
+	for (auto &command : commands)
+	{
+		command();
+	}
+}
+
+void GameModel::QueueSimulationCommand(std::function<void ()> command)
+{
+	if (simulationStepRunning)
+	{
+		simulationCommands.push_back(std::move(command));
+		return;
+	}
+	command();
+}
+
+void GameModel::SimulationThread()
+{
+	while (true)
+	{
+		{
+			std::unique_lock lk(simulationThreadMx);
+			simulationThreadCv.wait(lk, [this]() {
+				return simulationThreadState == simulationThreadStopping || simulationThreadOwnsSimulation;
+			});
+			if (simulationThreadState == simulationThreadStopping)
+			{
+				break;
+			}
+		}
+		sim->UpdateParticles(0, NPART);
+		{
+			std::lock_guard lk(simulationThreadMx);
+			simulationThreadOwnsSimulation = false;
+		}
+		simulationThreadCv.notify_all();
+	}
+}
+
+void GameModel::StopSimulationThread()
+{
+	bool join = false;
+	{
+		std::lock_guard lk(simulationThreadMx);
+		if (simulationThreadState != simulationThreadAbsent)
+		{
+			simulationThreadState = simulationThreadStopping;
+			join = true;
+		}
+	}
+	if (join)
+	{
+		simulationThreadCv.notify_all();
+		simulationThread.join();
+	}
+}
+
 Tool *GameModel::GetToolByIndex(int index)
 {
 	if (index < 0 || index >= int(tools.size()))
@@ -11,6 +11,9 @@
 #include <optional>
 #include <functional>
 #include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 constexpr auto NUM_TOOLINDICES = 4;
 
@@ -142,6 +145,28 @@ private:
 
 	bool threadedRendering = false;
 
+	// The simulation thread only ever runs Simulation::UpdateParticles, BeforeSim and
+	// AfterSim stay on the UI thread because they call into Lua. A step is queued by
+	// StepSimulation when the sim ticks, dispatched once the frame has been drawn, and
+	// finished by the first thing that needs the simulation afterwards, see GetSimulation.
+	bool threadedSimulation = false;
+	enum SimulationThreadState
+	{
+		simulationThreadAbsent,
+		simulationThreadRunning,
+		simulationThreadStopping,
+	};
+	SimulationThreadState simulationThreadState = simulationThreadAbsent;
+	std::thread simulationThread;
+	std::mutex simulationThreadMx;
+	std::condition_variable simulationThreadCv;
+	bool simulationThreadOwnsSimulation = false;
+	bool simulationStepQueued = false;
+	bool simulationStepRunning = false;
+	std::vector<std::function<void ()>> simulationCommands;
+	void SimulationThread();
+	void StopSimulationThread();
+
 	GameView *view;
 
 public:
@@ -164,6 +189,11 @@ public:
 	{
 		return threadedRendering;
 	}
+	void SetThreadedSimulation(bool newThreadedSimulation);
+	bool GetThreadedSimulation() const
+	{
+		return threadedSimulation;
+	}
 	void SetAmbientAirTemperature(float ambientAirTemp);
 	float GetAmbientAirTemperature();
 	void SetVorticityCoeff(float vorticityCoeff);
@@ -266,6 +296,7 @@ public:
 	void FrameStep(int frames);
 	const std::optional<User> &GetUser() const;
 	void SetUser(std::optional<User> user);
+	// Finishes the step running on the simulation thread first, if any.
 	Simulation * GetSimulation();
 	Renderer * GetRenderer();
 	RendererSettings &GetRendererSettings()
@@ -322,6 +353,13 @@ public:
 	void BeforeSim();
 	void AfterSim();
 
+	// Does a whole step, on the simulation thread if threaded is true, see threadedSimulation.
+	void StepSimulation(bool threaded);
+	void DispatchSimulationStep();
+	void FinishSimulationStep();
+	// Runs command right away, or after the step running on the simulation thread, if any.
+	void QueueSimulationCommand(std::function<void ()> command);
+
 	GameView *GetView() const
 	{
 		return view;
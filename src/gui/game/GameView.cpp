@@ -22,6 +22,7 @@
 #include "client/GameSave.h"
 #include "common/platform/Platform.h"
 #include "graphics/Graphics.h"
+#include "graphics/Recording.h"
 #include "graphics/Renderer.h"
 #include "graphics/VideoBuffer.h"
 #include "gui/Style.h"
@@ -196,7 +197,6 @@ GameView::GameView():
 	doScreenshot(false),
 	screenshotIndex(1),
 	lastScreenshotTime(0),
-	recordingIndex(0),
 	recording(false),
 	recordingFolder(0),
 	currentPoint(ui::Point(0, 0)),
@@ -1019,6 +1019,8 @@ int GameView::Record(bool record)
 	{
 		recording = false;
 		recordingFolder = 0;
+		// waits for the queued frames to be written
+		recorder.reset();
 	}
 	else if (!recording)
 	{
@@ -1026,8 +1028,16 @@ int GameView::Record(bool record)
 		recordingFolder = startTime;
 		Platform::MakeDirectory("recordings");
 		Platform::MakeDirectory(ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder));
-		recording = true;
-		recordingIndex = 0;
+		recorder = std::make_unique<RecordingWriter>(ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder, PATH_SEP_CHAR, "recording.tptrec"), RendererFrameSize);
+		if (recorder->Good())
+		{
+			recording = true;
+		}
+		else
+		{
+			recorder.reset();
+			recordingFolder = 0;
+		}
 	}
 	return recordingFolder;
 }
@@ -1811,10 +1821,35 @@ void GameView::OnTick()
 
 void GameView::OnSimTick()
 {
-	c->Update();
+	auto start = Platform::GetTime();
+	for (auto i = 0; i < turboMode.steps; ++i)
+	{
+		// * Only the frame drawn next gets rendered, the ones before it are never handed
+		//   to the renderer. Fire and persistent effects fade once per drawn frame and so
+		//   fade more slowly relative to the simulation.
+		if (i && (c->GetPaused() || (turboMode.budget && Platform::GetTime() - start >= (unsigned long)turboMode.budget)))
+		{
+			break;
+		}
+		if (!c->GetPaused())
+		{
+			simFrameCount += 1;
+		}
+		c->Update();
+	}
+	auto now = Platform::GetTime();
+	if (now - simFrameCountStart >= 1000)
+	{
+		simFrameRate = simFrameCount * 1000.f / float(now - simFrameCountStart);
+		simFrameCount = 0;
+		simFrameCountStart = now;
+	}
 	wantFrame = true;
 }
 
+// All input other than mouse movement waits for the step running on the simulation
+// thread, if any, see GameModel::StepSimulation. Mouse movement may draw, but drawing
+// goes through GameModel::QueueSimulationCommand.
 void GameView::DoMouseMove(int x, int y, int dx, int dy)
 {
 	if(c->MouseMove(x, y, dx, dy))
@@ -1823,6 +1858,7 @@ void GameView::DoMouseMove(int x, int y, int dx, int dy)
 
 void GameView::DoMouseDown(int x, int y, unsigned button)
 {
+	c->FinishSimulationStep();
 	if(introText > 50)
 		introText = 50;
 	if(c->MouseDown(x, y, button))
@@ -1831,30 +1867,35 @@ void GameView::DoMouseDown(int x, int y, unsigned button)
 
 void GameView::DoMouseUp(int x, int y, unsigned button)
 {
+	c->FinishSimulationStep();
 	if(c->MouseUp(x, y, button, GameController::mouseUpNormal))
 		Window::DoMouseUp(x, y, button);
 }
 
 void GameView::DoMouseWheel(int x, int y, int d)
 {
+	c->FinishSimulationStep();
 	if(c->MouseWheel(x, y, d))
 		Window::DoMouseWheel(x, y, d);
 }
 
 void GameView::DoTextInput(String text)
 {
+	c->FinishSimulationStep();
 	if (c->TextInput(text))
 		Window::DoTextInput(text);
 }
 
 void GameView::DoTextEditing(String text)
 {
+	c->FinishSimulationStep();
 	if (c->TextEditing(text))
 		Window::DoTextEditing(text);
 }
 
 void GameView::DoKeyPress(int key, int scan, bool repeat, bool shift, bool ctrl, bool alt)
 {
+	c->FinishSimulationStep();
 	if (shift && !shiftBehaviour)
 		enableShiftBehaviour();
 	if (ctrl && !ctrlBehaviour)
@@ -1867,6 +1908,7 @@ void GameView::DoKeyPress(int key, int scan, bool repeat, bool shift, bool ctrl,
 
 void GameView::DoKeyRelease(int key, int scan, bool repeat, bool shift, bool ctrl, bool alt)
 {
+	c->FinishSimulationStep();
 	if (!shift && shiftBehaviour)
 		disableShiftBehaviour();
 	if (!ctrl && ctrlBehaviour)
@@ -1885,6 +1927,7 @@ void GameView::DoExit()
 
 void GameView::DoDraw()
 {
+	c->FinishSimulationStep();
 	Window::DoDraw();
 	constexpr std::array<int, 9> fadeout = { { // * Gamma-corrected.
 		255, 195, 145, 103, 69, 42, 23, 10, 3
@@ -1901,6 +1944,9 @@ void GameView::DoDraw()
 		auto rect = g->Size().OriginRect();
 		g->SwapClipRect(rect);  // reset any nonsense cliprect Lua left configured
 	}
+	// * The simulation thread gets to work while the frame is presented and until the next
+	//   input event or sim tick that needs the simulation.
+	c->DispatchSimulationStep();
 }
 
 void GameView::NotifyNotificationsChanged(GameModel * sender)
@@ -2304,11 +2350,8 @@ void GameView::OnDraw()
 
 	if(recording)
 	{
-		std::vector<char> data = VideoBuffer(*rendererFrame).ToPPM();
-
-		ByteString filename = ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder, PATH_SEP_CHAR, "frame_", Format::Width(recordingIndex++, 6), ".ppm");
-
-		Platform::WriteFile(data, filename);
+		// encoded and written on the recorder's own thread, see graphics/Recording.h
+		recorder->Push(rendererFrame->data());
 	}
 
 	if (logEntries.size())
@@ -2528,6 +2571,10 @@ void GameView::OnDraw()
 		//FPS and some version info
 		StringBuilder fpsInfo;
 		fpsInfo << Format::Precision(2) << "FPS: " << ui::Engine::Ref().GetFps();
+		if (turboMode.steps > 1)
+		{
+			fpsInfo << " Sim FPS: " << simFrameRate << " [TURBO]";
+		}
 
 		if (showDebug)
 		{
@@ -2565,6 +2612,12 @@ void GameView::OnDraw()
 			{
 				fpsInfo << std::get<FpsLimitExplicit>(simFpsLimit).value;
 			}
+			fpsInfo << "\n  Steps per tick: " << turboMode.steps;
+			if (turboMode.budget)
+			{
+				fpsInfo << ", budget: " << turboMode.budget << "ms";
+			}
+			fpsInfo << "\n  Sim FPS: " << simFrameRate;
 		}
 		if (c->GetDebugFlags() & DEBUG_RENHUD)
 		{
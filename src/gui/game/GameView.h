@@ -36,6 +36,7 @@ class Simulation;
 struct RenderableSimulation;
 
 class MenuButton;
+class RecordingWriter;
 class Renderer;
 struct RendererSettings;
 class VideoBuffer;
@@ -81,9 +82,9 @@ private:
 	bool doScreenshot;
 	int screenshotIndex;
 	time_t lastScreenshotTime;
-	int recordingIndex;
 	bool recording;
 	int recordingFolder;
+	std::unique_ptr<RecordingWriter> recorder;
 
 	ui::Point currentPoint, lastPoint;
 	GameController * c;
@@ -180,6 +181,12 @@ private:
 	SimFpsLimit simFpsLimit = FpsLimitExplicit{ 60.f };
 	void ApplySimFpsLimit();
 
+	TurboMode turboMode;
+	// * Simulation frames per second, which differs from the FPS the engine reports in turbo mode.
+	int simFrameCount = 0;
+	unsigned long simFrameCountStart = 0;
+	float simFrameRate = 0;
+
 public:
 	GameView();
 	~GameView();
@@ -289,4 +296,13 @@ public:
 	{
 		return simFpsLimit;
 	}
+
+	void SetTurboMode(TurboMode newTurboMode)
+	{
+		turboMode = newTurboMode;
+	}
+	TurboMode GetTurboMode() const
+	{
+		return turboMode;
+	}
 };
@@ -202,6 +202,7 @@ void PropertyTool::SetProperty(Simulation *sim, ui::Point position)
 	if(!i)
 		return;
 	configuration->changeProperty.Set(sim, ID(i));
+	sim->WakeBlock(position.X, position.Y);
 }
 
 void PropertyTool::Draw(Simulation *sim, Brush const &cBrush, ui::Point position)
@@ -292,7 +293,10 @@ void PropertyTool::DrawRect(Simulation *sim, Brush const &cBrush, ui::Point posi
 void PropertyTool::DrawFill(Simulation *sim, Brush const &cBrush, ui::Point position)
 {
 	if (configuration)
+	{
 		sim->flood_prop(position.X, position.Y, configuration->changeProperty);
+		sim->WakeAllBlocks();
+	}
 }
 
 void PropertyTool::Select(int toolSelection)
@@ -100,6 +100,11 @@ void LocalBrowserController::RescanStamps()
 	browserModel->UpdateSavesList(browserModel->GetPageNum());
 }
 
+void LocalBrowserController::SetFilter(String filter)
+{
+	browserModel->SetFilter(filter.ToUtf8());
+}
+
 void LocalBrowserController::RefreshSavesList()
 {
 	ClearSelection();
@@ -21,6 +21,7 @@ public:
 	void ClearSelection();
 	void Selected(ByteString stampID, bool selected);
 	void RescanStamps();
+	void SetFilter(String filter);
 	void RefreshSavesList();
 	void OpenSave(int index);
 	bool GetMoveToFront();
@@ -3,6 +3,7 @@
 #include "client/Client.h"
 #include "client/SaveFile.h"
 #include "client/GameSave.h"
+#include "client/StampIndex.h"
 #include <algorithm>
 
 constexpr auto pageSize = 20;
@@ -79,7 +80,12 @@ void LocalBrowserModel::UpdateSavesList(int pageNumber)
 	savesList.clear();
 	currentPage = pageNumber;
 
-	stampIDs = Client::Ref().GetStamps();
+	auto &client = Client::Ref();
+	stampIDs = client.GetStamps();
+	if (filter.size())
+	{
+		stampIDs = client.GetStampIndex().Filter(stampIDs, StampIndex::Query::Parse(filter));
+	}
 	auto size = int(stampIDs.size());
 	for (int i = currentPage * pageSize; i < size && i < (currentPage + 1) * pageSize; i++)
 	{
@@ -98,6 +104,12 @@ void LocalBrowserModel::RescanStamps()
 	Client::Ref().RescanStamps();
 }
 
+void LocalBrowserModel::SetFilter(ByteString newFilter)
+{
+	filter = newFilter;
+	UpdateSavesList(0);
+}
+
 int LocalBrowserModel::GetPageCount()
 {
 	auto size = int(stampIDs.size());
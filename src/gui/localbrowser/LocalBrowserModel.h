@@ -10,6 +10,7 @@ class LocalBrowserModel {
 	std::vector<ByteString> selected;
 	std::unique_ptr<SaveFile> stamp;
 	std::vector<ByteString> stampIDs;
+	ByteString filter;
 	std::vector<std::unique_ptr<SaveFile>> savesList;
 	std::vector<LocalBrowserView*> observers;
 	int currentPage = 0;
@@ -25,6 +26,7 @@ public:
 	std::vector<SaveFile *> GetSavesList(); // non-owning
 	void UpdateSavesList(int pageNumber);
 	void RescanStamps();
+	void SetFilter(ByteString newFilter);
 	const SaveFile *GetSave();
 	std::unique_ptr<SaveFile> TakeSave();
 	void OpenSave(int index);
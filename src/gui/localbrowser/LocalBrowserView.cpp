@@ -55,6 +55,20 @@ LocalBrowserView::LocalBrowserView():
 
 	AddComponent(removeSelected);
 	AddComponent(renameSelected);
+
+	filterField = new ui::Textbox(ui::Point(60, 10), ui::Point(WINDOWW-120, 17), "", "[filter: element names, ngrav, aheat]");
+	filterField->Appearance.icon = IconSearch;
+	filterField->Appearance.HorizontalAlign = ui::Appearance::AlignLeft;
+	filterField->Appearance.VerticalAlign = ui::Appearance::AlignMiddle;
+	filterField->SetActionCallback({ [this] { filterChanged(); } });
+	filterField->SetLimit(100);
+	AddComponent(filterField);
+}
+
+void LocalBrowserView::filterChanged()
+{
+	filterDirty = true;
+	filterLastChanged = GetTicks()+300;
 }
 
 void LocalBrowserView::textChanged()
@@ -76,6 +90,11 @@ void LocalBrowserView::OnTick()
 		changed = false;
 		c->SetPage(std::max(pageTextbox->GetText().ToNumber<int>(true) - 1, 0));
 	}
+	if (filterDirty && filterLastChanged < GetTicks())
+	{
+		filterDirty = false;
+		c->SetFilter(filterField->GetText());
+	}
 }
 
 void LocalBrowserView::NotifyPageChanged(LocalBrowserModel * sender)
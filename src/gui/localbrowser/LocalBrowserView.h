@@ -21,11 +21,15 @@ class LocalBrowserView: public ui::Window {
 	ui::Label * pageLabel;
 	ui::Label * pageCountLabel;
 	ui::Textbox * pageTextbox;
+	ui::Textbox * filterField;
 	ui::Button * removeSelected;
 	ui::Button *renameSelected;
 
 	void textChanged();
+	void filterChanged();
 	bool changed;
+	bool filterDirty = false;
+	unsigned int filterLastChanged = 0;
 	unsigned int lastChanged;
 	int pageCount;
 public:
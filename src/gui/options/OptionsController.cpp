@@ -97,6 +97,11 @@ void OptionsController::SetThreadedRendering(bool newThreadedRendering)
 	model->SetThreadedRendering(newThreadedRendering);
 }
 
+void OptionsController::SetThreadedSimulation(bool newThreadedSimulation)
+{
+	model->SetThreadedSimulation(newThreadedSimulation);
+}
+
 void OptionsController::SetFullscreen(bool fullscreen)
 {
 	model->SetFullscreen(fullscreen);
@@ -144,6 +144,18 @@ void OptionsModel::SetThreadedRendering(bool newThreadedRendering)
 	notifySettingsChanged();
 }
 
+int OptionsModel::GetThreadedSimulation()
+{
+	return gModel->GetThreadedSimulation();
+}
+
+void OptionsModel::SetThreadedSimulation(bool newThreadedSimulation)
+{
+	GlobalPrefs::Ref().Set("Simulation.SeparateThread", newThreadedSimulation);
+	gModel->SetThreadedSimulation(newThreadedSimulation);
+	notifySettingsChanged();
+}
+
 float OptionsModel::GetAmbientAirTemperature()
 {
 	return gModel->GetSimulation()->air->ambientAirTemp;
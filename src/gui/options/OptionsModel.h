@@ -42,6 +42,8 @@ public:
 	void SetTemperatureScale(TempScale temperatureScale);
 	int GetThreadedRendering();
 	void SetThreadedRendering(bool newThreadedRendering);
+	int GetThreadedSimulation();
+	void SetThreadedSimulation(bool newThreadedSimulation);
 	int GetGravityMode();
 	void SetGravityMode(int gravityMode);
 	float GetCustomGravityX();
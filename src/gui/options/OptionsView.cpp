@@ -343,6 +343,9 @@ OptionsView::OptionsView() : ui::Window(ui::Point(-1, -1), ui::Point(320, 340))
 	threadedRendering = addCheckbox(0, "Separate rendering thread", "May increase framerate when fancy effects are in use", [this] {
 		c->SetThreadedRendering(threadedRendering->GetChecked());
 	});
+	threadedSimulation = addCheckbox(0, "Separate simulation thread", "Keeps the interface responsive when the simulation is slow, disabled while Lua elements are in use", [this] {
+		c->SetThreadedSimulation(threadedSimulation->GetChecked());
+	});
 	decoSpace = addDropDown("Colour space used by decoration tools", {
 		{ "sRGB", DECOSPACE_SRGB },
 		{ "Linear", DECOSPACE_LINEAR },
@@ -651,6 +654,7 @@ void OptionsView::NotifySettingsChanged(OptionsModel * sender)
 	perfectCircle->SetChecked(sender->GetPerfectCircle());
 	graveExitsConsole->SetChecked(sender->GetGraveExitsConsole());
 	threadedRendering->SetChecked(sender->GetThreadedRendering());
+	threadedSimulation->SetChecked(sender->GetThreadedSimulation());
 	momentumScroll->SetChecked(sender->GetMomentumScroll());
 	redirectStd->SetChecked(sender->GetRedirectStd());
 	autoStartupRequest->SetChecked(sender->GetAutoStartupRequest());
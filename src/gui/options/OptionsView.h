@@ -48,6 +48,7 @@ class OptionsView: public ui::Window
 	ui::Checkbox *graveExitsConsole{};
 	ui::Checkbox *nativeClipoard{};
 	ui::Checkbox *threadedRendering{};
+	ui::Checkbox *threadedSimulation{};
 	ui::Checkbox *redirectStd{};
 	ui::Checkbox *autoStartupRequest{};
 	ui::Label *startupRequestStatus{};
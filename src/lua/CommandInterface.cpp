@@ -30,21 +30,9 @@ void CommandInterface::Log(LogType type, String message)
 
 static std::optional<int> GetPropertyOffset(ByteString key)
 {
-	for (auto &alias : Particle::GetPropertyAliases())
+	if (auto index = Particle::GetPropertyIndex(key))
 	{
-		if (key == alias.from)
-		{
-			key = alias.to;
-		}
-	}
-	auto &properties = Particle::GetProperties();
-	for (int i = 0; i < int(properties.size()); ++i)
-	{
-		auto &prop = properties[i];
-		if (key == prop.Name)
-		{
-			return i;
-		}
+		return int(*index);
 	}
 	return std::nullopt;
 }
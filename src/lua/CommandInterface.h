@@ -34,7 +34,9 @@ public:
 	void Init();
 
 	bool HandleEvent(const GameControllerEvent &event);
+	void FlushCustomElementBatches();
 	bool HaveSimGraphicsEventHandlers();
+	bool HaveSimulationCallbacks();
 
 	int Command(String command);
 	String FormatCommand(String command);
@@ -106,6 +106,15 @@ static int luaUpdateWrapper(UPDATE_FUNC_ARGS)
 	auto &builtinElements = GetElements();
 	auto *builtinUpdate = builtinElements[parts[i].type].Update;
 	auto &customElements = lsi->customElements;
+	if (customElements[parts[i].type].updateMode == UPDATE_BATCH)
+	{
+		if (builtinUpdate && builtinUpdate(UPDATE_FUNC_SUBCALL_ARGS))
+			return 1;
+		auto &batch = customElements[parts[i].type].batch;
+		batch.ids.push_back(i);
+		batch.generations.push_back(sim->partGenerations[i]);
+		return 0;
+	}
 	if (builtinUpdate && customElements[parts[i].type].updateMode == UPDATE_AFTER)
 	{
 		if (builtinUpdate(UPDATE_FUNC_SUBCALL_ARGS))
@@ -146,6 +155,61 @@ static int luaUpdateWrapper(UPDATE_FUNC_ARGS)
 	return 0;
 }
 
+void CommandInterface::FlushCustomElementBatches()
+{
+	auto *lsi = static_cast<LuaScriptInterface *>(this);
+	auto *L = lsi->L;
+	auto *sim = lsi->sim;
+	auto &customElements = lsi->customElements;
+	if (!sim->useLuaCallbacks)
+	{
+		return;
+	}
+	for (int t = 0; t < int(customElements.size()); ++t)
+	{
+		auto &batch = customElements[t].batch;
+		if (batch.ids.empty())
+		{
+			continue;
+		}
+		if (customElements[t].updateMode != UPDATE_BATCH || !customElements[t].update)
+		{
+			batch.Clear();
+			continue;
+		}
+		lua_rawgeti(L, LUA_REGISTRYINDEX, customElements[t].update);
+		auto *ids = PushPartBuffer(L, 0);
+		auto *xs = PushPartBuffer(L, 0);
+		auto *ys = PushPartBuffer(L, 0);
+		ids->values.reserve(batch.ids.size());
+		xs->values.reserve(batch.ids.size());
+		ys->values.reserve(batch.ids.size());
+		for (int j = 0; j < int(batch.ids.size()); ++j)
+		{
+			auto id = batch.ids[j];
+			if (sim->parts[id].type == t && sim->partGenerations[id] == batch.generations[j])
+			{
+				ids->values.push_back(id);
+				xs->values.push_back((int)(sim->parts[id].x+0.5f));
+				ys->values.push_back((int)(sim->parts[id].y+0.5f));
+			}
+		}
+		auto count = ids->values.size();
+		lua_pushinteger(L, count);
+		// the callback may add to this element's batch again, e.g. via sim.updateUpTo; start from a clean slate
+		batch.Clear();
+		if (!count)
+		{
+			lua_pop(L, 5);
+			continue;
+		}
+		if (tpt_lua_pcall(L, 4, 0, 0, eventTraitSimRng))
+		{
+			Log(CommandInterface::LogError, LuaGetError());
+		}
+	}
+}
+
 static int luaGraphicsWrapper(GRAPHICS_FUNC_ARGS)
 {
 	if (!gfctx.sim->useLuaCallbacks)
@@ -449,12 +513,14 @@ static int element(lua_State *L)
 			if (lua_type(L, -1) == LUA_TFUNCTION)
 			{
 				customElements[id].update.Assign(L, -1);
+				customElements[id].batch.Clear();
 				customElements[id].updateMode = UPDATE_AFTER;
 				elements[id].Update = luaUpdateWrapper;
 			}
 			else if (lua_type(L, -1) == LUA_TBOOLEAN && !lua_toboolean(L, -1))
 			{
 				customElements[id].update.Clear();
+				customElements[id].batch.Clear();
 				customElements[id].updateMode = UPDATE_AFTER;
 				elements[id].Update = builtinElements[id].Update;
 			}
@@ -607,8 +673,13 @@ static int property(lua_State *L)
 		{
 			if (lua_type(L, 3) == LUA_TFUNCTION)
 			{
+				customElements[id].batch.Clear();
 				switch (luaL_optint(L, 4, 0))
 				{
+				case 3:
+					customElements[id].updateMode = UPDATE_BATCH;
+					break;
+
 				case 2:
 					customElements[id].updateMode = UPDATE_BEFORE;
 					break;
@@ -627,9 +698,11 @@ static int property(lua_State *L)
 			else if (lua_type(L, 3) == LUA_TBOOLEAN && !lua_toboolean(L, 3))
 			{
 				customElements[id].update.Clear();
+				customElements[id].batch.Clear();
 				customElements[id].updateMode = UPDATE_AFTER;
 				elements[id].Update = builtinElements[id].Update;
 			}
+			sd.UpdateHotElements();
 		}
 		else if (propertyName == "Graphics")
 		{
@@ -753,6 +826,7 @@ static int ffree(lua_State *L)
 		auto &sd = SimulationData::Ref();
 		std::unique_lock lk(sd.elementGraphicsMx);
 		sd.elements[id].Enabled = false;
+		sd.UpdateHotElements();
 	}
 	lsi->customElements[id] = {};
 	lsi->gameModel->FreeTool(lsi->gameModel->GetToolFromIdentifier(identifier));
@@ -911,6 +985,7 @@ void LuaElements::Open(lua_State *L)
 	LCONST(UPDATE_AFTER);
 	LCONST(UPDATE_REPLACE);
 	LCONST(UPDATE_BEFORE);
+	LCONST(UPDATE_BATCH);
 	LCONST(NUM_UPDATEMODES);
 #undef LCONSTAS
 #undef LCONST
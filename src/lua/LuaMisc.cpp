@@ -225,6 +225,32 @@ static int fpsCap(lua_State *L)
 	return 0;
 }
 
+static int turbo(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	lsi->AssertInterfaceEvent();
+	if (lua_gettop(L) == 0)
+	{
+		auto turboMode = lsi->window->GetTurboMode();
+		lua_pushinteger(L, turboMode.steps);
+		lua_pushinteger(L, turboMode.budget);
+		return 2;
+	}
+	TurboMode turboMode;
+	turboMode.steps = luaL_checkint(L, 1);
+	turboMode.budget = luaL_optint(L, 2, 0);
+	if (turboMode.steps < 1)
+	{
+		return luaL_error(L, "step count too small");
+	}
+	if (turboMode.budget < 0)
+	{
+		return luaL_error(L, "time budget too small");
+	}
+	lsi->window->SetTurboMode(turboMode);
+	return 0;
+}
+
 static int drawCap(lua_State *L)
 {
 	GetLSI()->AssertInterfaceEvent();
@@ -274,6 +300,7 @@ void LuaMisc::Open(lua_State *L)
 		LFUNC(record),
 		LFUNC(debug),
 		LFUNC(fpsCap),
+		LFUNC(turbo),
 		LFUNC(drawCap),
 		LFUNC(compatChunk),
 #undef LFUNC
@@ -13,6 +13,7 @@
 #include "prefs/GlobalPrefs.h"
 #include "simulation/Simulation.h"
 #include "simulation/SimulationData.h"
+#include <algorithm>
 
 static int atPanic(lua_State *L)
 {
@@ -181,6 +182,7 @@ void LuaScriptInterface::InitCustomCanMove()
 {
 	auto &sd = SimulationData::Ref();
 	sd.init_can_move();
+	sd.UpdateHotElements();
 	for (auto moving = 0; moving < PT_NUM; ++moving)
 	{
 		for (auto into = 0; into < PT_NUM; ++into)
@@ -272,7 +274,7 @@ void LuaGetProperty(lua_State *L, StructProperty property, intptr_t propertyAddr
 	}
 }
 
-static int32_t int32_truncate(double n)
+int32_t int32_truncate(double n)
 {
 	if (n >= 0x1p31)
 	{
@@ -514,6 +516,16 @@ bool CommandInterface::HaveSimGraphicsEventHandlers()
 	return HaveSimGraphicsEventHandlersHelper<0>(lsi->gameControllerEventHandlers);
 }
 
+bool CommandInterface::HaveSimulationCallbacks()
+{
+	// * These are the callbacks Simulation::UpdateParticles may call, ctypeDraw and graphics are
+	//   only called by tools and the renderer.
+	auto *lsi = static_cast<LuaScriptInterface *>(this);
+	return std::any_of(lsi->customElements.begin(), lsi->customElements.end(), [](auto &customElement) {
+		return customElement.update || customElement.create || customElement.createAllowed || customElement.changeType;
+	});
+}
+
 void CommandInterface::OnTick()
 {
 	auto *lsi = static_cast<LuaScriptInterface *>(this);
@@ -866,6 +878,8 @@ bool tpt_lua_equalsString(lua_State *L, int index, const char *data, size_t size
 int tpt_lua_pcall(lua_State *L, int numArgs, int numResults, int errorFunc, EventTraits newEventTraits)
 {
 	auto *lsi = GetLSI();
+	// * Lua code may touch the simulation at any time, so it can't run alongside the simulation thread.
+	lsi->gameModel->FinishSimulationStep();
 	lsi->luaExecutionStart = Platform::GetTime();
 	struct AtReturn
 	{
@@ -11,6 +11,7 @@
 #include <memory>
 #include <list>
 #include <deque>
+#include <vector>
 
 namespace http
 {
@@ -33,6 +34,15 @@ String LuaGetError();
 void LuaGetProperty(lua_State *L, StructProperty property, intptr_t propertyAddress);
 void LuaSetProperty(lua_State *L, StructProperty property, intptr_t propertyAddress, int stackPos);
 void LuaSetParticleProperty(lua_State *L, int particleID, StructProperty property, intptr_t propertyAddress, int stackPos);
+int32_t int32_truncate(double n);
+
+// Flat array of numbers, see sim.partBuffer
+struct PartBuffer
+{
+	static constexpr const char *className = "PartBuffer";
+	std::vector<double> values;
+};
+PartBuffer *PushPartBuffer(lua_State *L, size_t size);
 
 struct LuaStateDeleter
 {
@@ -48,13 +58,32 @@ enum UpdateMode
 	UPDATE_AFTER,
 	UPDATE_REPLACE,
 	UPDATE_BEFORE,
+	// The builtin update (if any) runs in place, and the Lua function is called once per frame
+	// after the particle loop with PartBuffers of IDs and positions (ids, xs, ys, count). Elements
+	// are flushed in increasing element ID order, particles in the order they were updated, and
+	// positions are those at the time of the flush. Entries whose particle has died or no longer
+	// has the element's type by then are dropped, even if its ID has since gone to a new particle.
+	UPDATE_BATCH,
 	NUM_UPDATEMODES,
 };
 
+struct CustomElementBatch
+{
+	std::vector<int> ids;
+	std::vector<uint32_t> generations; // * Simulation::partGenerations of each ID when it was recorded.
+
+	void Clear()
+	{
+		ids.clear();
+		generations.clear();
+	}
+};
+
 struct CustomElement
 {
 	UpdateMode updateMode = UPDATE_AFTER;
 	LuaSmartRef update;
+	CustomElementBatch batch;
 	LuaSmartRef graphics;
 	LuaSmartRef ctypeDraw;
 	LuaSmartRef create;
@@ -3,6 +3,7 @@
 #include "client/GameSave.h"
 #include "client/SaveFile.h"
 #include "client/SaveInfo.h"
+#include "client/StampIndex.h"
 #include "common/RasterGeometry.h"
 #include "Format.h"
 #include "gui/game/GameController.h"
@@ -16,6 +17,8 @@
 #include "simulation/gravity/Gravity.h"
 #include "simulation/Snapshot.h"
 #include "simulation/ToolClasses.h"
+#include <cstddef>
+#include <limits>
 #include <type_traits>
 
 static int ambientHeatSim(lua_State *L)
@@ -50,6 +53,49 @@ static int heatSim(lua_State *L)
 	return 0;
 }
 
+static int sleepingRegions(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	int acount = lua_gettop(L);
+	if (acount == 0)
+	{
+		lua_pushboolean(L, lsi->sim->sleepingRegions);
+		return 1;
+	}
+	lsi->AssertInterfaceEvent();
+	lsi->sim->sleepingRegions = lua_toboolean(L, 1);
+	lsi->sim->WakeAllBlocks();
+	return 0;
+}
+
+static int gridHeat(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	int acount = lua_gettop(L);
+	if (acount == 0)
+	{
+		lua_pushboolean(L, lsi->sim->gridHeat);
+		return 1;
+	}
+	lsi->AssertInterfaceEvent();
+	lsi->sim->gridHeat = lua_toboolean(L, 1);
+	return 0;
+}
+
+static int serialBeforeSim(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	int acount = lua_gettop(L);
+	if (acount == 0)
+	{
+		lua_pushboolean(L, lsi->sim->serialBeforeSim);
+		return 1;
+	}
+	lsi->AssertInterfaceEvent();
+	lsi->sim->serialBeforeSim = lua_toboolean(L, 1);
+	return 0;
+}
+
 static int newtonianGravity(lua_State *L)
 {
 	auto *lsi = GetLSI();
@@ -412,12 +458,33 @@ static int partPosition(lua_State *L)
 	}
 }
 
+static unsigned int CheckParticleField(lua_State *L, int index)
+{
+	auto &properties = Particle::GetProperties();
+	if (lua_type(L, index) == LUA_TNUMBER)
+	{
+		int fieldID = lua_tointeger(L, index);
+		if (fieldID < 0 || fieldID >= (int)properties.size())
+			luaL_error(L, "Invalid field ID (%d)", fieldID);
+		return fieldID;
+	}
+	else if (lua_type(L, index) == LUA_TSTRING)
+	{
+		auto fieldName = tpt_lua_toByteString(L, index);
+		auto fieldID = Particle::GetPropertyIndex(fieldName);
+		if (!fieldID)
+			luaL_error(L, "Unknown field (%s)", fieldName.c_str());
+		return *fieldID;
+	}
+	luaL_error(L, "Field ID must be an name (string) or identifier (integer)");
+	return 0;
+}
+
 static int partProperty(lua_State *L)
 {
 	auto *lsi = GetLSI();
 	int argCount = lua_gettop(L);
 	int particleID = luaL_checkinteger(L, 1);
-	StructProperty property;
 
 	if (particleID < 0 || particleID >= NPART || !lsi->sim->parts[particleID].type)
 	{
@@ -430,50 +497,364 @@ static int partProperty(lua_State *L)
 		return 1;
 	}
 
-	auto &properties = Particle::GetProperties();
-	auto prop = properties.end();
+	auto &prop = Particle::GetProperties()[CheckParticleField(L, 2)];
+
+	//Calculate memory address of property
+	intptr_t propertyAddress = (intptr_t)(((unsigned char*)&lsi->sim->parts[particleID]) + prop.Offset);
+
+	if (argCount == 3)
+	{
+		LuaSetParticleProperty(L, particleID, prop, propertyAddress, 3);
+		lsi->sim->WakeParticle(particleID);
+		return 0;
+	}
+	LuaGetProperty(L, prop, propertyAddress);
+	return 1;
+}
+
+static int partFieldID(lua_State *L)
+{
+	auto fieldID = Particle::GetPropertyIndex(tpt_lua_checkByteString(L, 1));
+	if (!fieldID)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+	lua_pushinteger(L, *fieldID);
+	return 1;
+}
+
+// PartBuffers back the bulk particle property functions below. Indices are 1-based like
+// Lua tables, but values live in one contiguous allocation that is reused across calls.
+static PartBuffer *CheckPartBuffer(lua_State *L, int index)
+{
+	return reinterpret_cast<PartBuffer *>(luaL_checkudata(L, index, PartBuffer::className));
+}
 
-	//Get field
+PartBuffer *PushPartBuffer(lua_State *L, size_t size)
+{
+	auto *buf = reinterpret_cast<PartBuffer *>(lua_newuserdata(L, sizeof(PartBuffer)));
+	new(buf) PartBuffer;
+	luaL_newmetatable(L, PartBuffer::className);
+	lua_setmetatable(L, -2);
+	buf->values.resize(size);
+	return buf;
+}
+
+// Returns the buffer at index if one was passed, otherwise creates a new one; either way, the
+// buffer ends up on top of the stack so that it can be returned.
+static PartBuffer *OptPartBuffer(lua_State *L, int index)
+{
+	if (lua_isnoneornil(L, index))
+	{
+		return PushPartBuffer(L, 0);
+	}
+	auto *buf = CheckPartBuffer(L, index);
+	lua_pushvalue(L, index);
+	return buf;
+}
+
+static size_t CheckPartBufferIndex(lua_State *L, PartBuffer *buf, int index)
+{
+	auto i = luaL_checkinteger(L, index);
+	if (i < 1 || i > lua_Integer(buf->values.size()))
+	{
+		luaL_error(L, "index %d out of range", int(i));
+	}
+	return size_t(i - 1);
+}
+
+static int partBufferGC(lua_State *L)
+{
+	auto *buf = CheckPartBuffer(L, 1);
+	buf->~PartBuffer();
+	return 0;
+}
+
+static int partBufferIndex(lua_State *L)
+{
+	auto *buf = CheckPartBuffer(L, 1);
 	if (lua_type(L, 2) == LUA_TNUMBER)
 	{
-		int fieldID = lua_tointeger(L, 2);
-		if (fieldID < 0 || fieldID >= (int)properties.size())
-			return luaL_error(L, "Invalid field ID (%d)", fieldID);
-		prop = properties.begin() + fieldID;
+		lua_pushnumber(L, buf->values[CheckPartBufferIndex(L, buf, 2)]);
+		return 1;
+	}
+	lua_pushvalue(L, 2);
+	lua_rawget(L, lua_upvalueindex(1));
+	return 1;
+}
+
+static int partBufferNewIndex(lua_State *L)
+{
+	auto *buf = CheckPartBuffer(L, 1);
+	buf->values[CheckPartBufferIndex(L, buf, 2)] = luaL_checknumber(L, 3);
+	return 0;
+}
+
+static int partBufferSize(lua_State *L)
+{
+	auto *buf = CheckPartBuffer(L, 1);
+	lua_pushinteger(L, buf->values.size());
+	return 1;
+}
+
+static int partBufferResize(lua_State *L)
+{
+	auto *buf = CheckPartBuffer(L, 1);
+	auto size = luaL_checkinteger(L, 2);
+	if (size < 0)
+	{
+		return luaL_error(L, "invalid size %d", int(size));
 	}
-	else if (lua_type(L, 2) == LUA_TSTRING)
+	buf->values.resize(size, luaL_optnumber(L, 3, 0));
+	return 0;
+}
+
+static int partBufferFill(lua_State *L)
+{
+	auto *buf = CheckPartBuffer(L, 1);
+	std::fill(buf->values.begin(), buf->values.end(), luaL_checknumber(L, 2));
+	return 0;
+}
+
+static int partBufferTable(lua_State *L)
+{
+	auto *buf = CheckPartBuffer(L, 1);
+	lua_createtable(L, int(buf->values.size()), 0);
+	for (int i = 0; i < int(buf->values.size()); ++i)
 	{
-		ByteString fieldName = tpt_lua_toByteString(L, 2);
-		for (auto &alias : Particle::GetPropertyAliases())
+		lua_pushnumber(L, buf->values[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
+static int partBuffer(lua_State *L)
+{
+	auto size = luaL_optinteger(L, 1, 0);
+	if (size < 0)
+	{
+		return luaL_error(L, "invalid size %d", int(size));
+	}
+	auto *buf = PushPartBuffer(L, size);
+	std::fill(buf->values.begin(), buf->values.end(), luaL_optnumber(L, 2, 0));
+	return 1;
+}
+
+// Accepts either a PartBuffer or a plain table of particle IDs, so scripts that already
+// have an ID list in a table don't need to copy it first. IDs that don't fit in an int,
+// such as the NaNs partPropertyGet returns for dead particles, are an error.
+static std::vector<int> CheckPartIDList(lua_State *L, int index)
+{
+	auto toID = [L](int i, double value) {
+		if (!(value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()))
 		{
-			if (fieldName == alias.from)
-			{
-				fieldName = alias.to;
-			}
+			luaL_error(L, "invalid particle ID at index %d", i + 1);
 		}
-		prop = std::find_if(properties.begin(), properties.end(), [&fieldName](StructProperty const &p) {
-			return p.Name == fieldName;
-		});
-		if (prop == properties.end())
-			return luaL_error(L, "Unknown field (%s)", fieldName.c_str());
+		return int(value);
+	};
+	std::vector<int> ids;
+	if (lua_type(L, index) == LUA_TTABLE)
+	{
+		ids.resize(lua_objlen(L, index));
+		for (int i = 0; i < int(ids.size()); ++i)
+		{
+			lua_rawgeti(L, index, i + 1);
+			auto value = lua_tonumber(L, -1);
+			lua_pop(L, 1);
+			ids[i] = toID(i, value);
+		}
+		return ids;
 	}
-	else
+	auto *buf = CheckPartBuffer(L, index);
+	ids.resize(buf->values.size());
+	for (int i = 0; i < int(ids.size()); ++i)
 	{
-		return luaL_error(L, "Field ID must be an name (string) or identifier (integer)");
+		ids[i] = toID(i, buf->values[i]);
 	}
+	return ids;
+}
 
-	//Calculate memory address of property
-	intptr_t propertyAddress = (intptr_t)(((unsigned char*)&lsi->sim->parts[particleID]) + prop->Offset);
+static const StructProperty &CheckBulkParticleField(lua_State *L, int index)
+{
+	auto &prop = Particle::GetProperties()[CheckParticleField(L, index)];
+	switch (prop.Type)
+	{
+	case StructProperty::TransitionType:
+	case StructProperty::ParticleType:
+	case StructProperty::Integer:
+	case StructProperty::UInteger:
+	case StructProperty::Colour:
+	case StructProperty::Float:
+	case StructProperty::UChar:
+		break;
 
-	if (argCount == 3)
+	default:
+		luaL_error(L, "Field %s is not numeric", prop.Name.c_str());
+		break;
+	}
+	return prop;
+}
+
+static double GetNumericProperty(const StructProperty &prop, const Particle &part)
+{
+	auto *address = reinterpret_cast<const unsigned char *>(&part) + prop.Offset;
+	switch (prop.Type)
 	{
-		LuaSetParticleProperty(L, particleID, *prop, propertyAddress, 3);
-		return 0;
+	case StructProperty::UInteger:
+	case StructProperty::Colour:
+		return *reinterpret_cast<const unsigned int *>(address);
+
+	case StructProperty::Float:
+		return *reinterpret_cast<const float *>(address);
+
+	case StructProperty::UChar:
+		return *address;
+
+	default:
+		return *reinterpret_cast<const int *>(address);
+	}
+}
+
+static void SetNumericProperty(Simulation *sim, const StructProperty &prop, int i, double value)
+{
+	auto &part = sim->parts[i];
+	if (prop.Offset == offsetof(Particle, type))
+	{
+		sim->part_change_type(i, int(part.x + 0.5f), int(part.y + 0.5f), int32_truncate(value));
+		return;
+	}
+	if (prop.Offset == offsetof(Particle, x) || prop.Offset == offsetof(Particle, y))
+	{
+		auto nx = prop.Offset == offsetof(Particle, x) ? float(value) : part.x;
+		auto ny = prop.Offset == offsetof(Particle, y) ? float(value) : part.y;
+		sim->move(i, int(part.x + 0.5f), int(part.y + 0.5f), nx, ny);
+		return;
+	}
+	auto *address = reinterpret_cast<unsigned char *>(&part) + prop.Offset;
+	switch (prop.Type)
+	{
+	case StructProperty::UInteger:
+	case StructProperty::Colour:
+		*reinterpret_cast<unsigned int *>(address) = int32_truncate(value);
+		break;
+
+	case StructProperty::Float:
+		*reinterpret_cast<float *>(address) = value;
+		break;
+
+	case StructProperty::UChar:
+		*address = int32_truncate(value);
+		break;
+
+	default:
+		*reinterpret_cast<int *>(address) = int32_truncate(value);
+		break;
+	}
+	sim->WakeParticle(i);
+}
+
+static int partIDs(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	auto *sim = lsi->sim;
+	int type = luaL_optint(L, 1, PT_NONE);
+	auto *buf = OptPartBuffer(L, 2);
+	buf->values.clear();
+	for (int i = 0; i < sim->parts.active; ++i)
+	{
+		if (sim->parts[i].type && (type == PT_NONE || sim->parts[i].type == type))
+		{
+			buf->values.push_back(i);
+		}
+	}
+	return 1;
+}
+
+static int partPropertyGet(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	auto *sim = lsi->sim;
+	auto &prop = CheckBulkParticleField(L, 1);
+	auto ids = CheckPartIDList(L, 2);
+	auto *buf = OptPartBuffer(L, 3);
+	buf->values.resize(ids.size());
+	for (int j = 0; j < int(ids.size()); ++j)
+	{
+		auto i = ids[j];
+		if (i < 0 || i >= NPART || !sim->parts[i].type)
+		{
+			buf->values[j] = std::numeric_limits<double>::quiet_NaN();
+			continue;
+		}
+		buf->values[j] = GetNumericProperty(prop, sim->parts[i]);
+	}
+	return 1;
+}
+
+static int partPropertyGetType(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	auto *sim = lsi->sim;
+	auto &prop = CheckBulkParticleField(L, 1);
+	int type = luaL_checkint(L, 2);
+	auto *buf = CheckPartBuffer(L, 3);
+	PartBuffer *idBuf = lua_isnoneornil(L, 4) ? nullptr : CheckPartBuffer(L, 4);
+	buf->values.clear();
+	if (idBuf)
+	{
+		idBuf->values.clear();
 	}
-	LuaGetProperty(L, *prop, propertyAddress);
+	for (int i = 0; i < sim->parts.active; ++i)
+	{
+		if (sim->parts[i].type && (type == PT_NONE || sim->parts[i].type == type))
+		{
+			buf->values.push_back(GetNumericProperty(prop, sim->parts[i]));
+			if (idBuf)
+			{
+				idBuf->values.push_back(i);
+			}
+		}
+	}
+	lua_pushinteger(L, buf->values.size());
 	return 1;
 }
 
+static int partPropertySet(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	auto *sim = lsi->sim;
+	lsi->AssertMonopartAccessEvent(-1);
+	auto &prop = CheckBulkParticleField(L, 1);
+	auto ids = CheckPartIDList(L, 2);
+	if (lua_type(L, 3) == LUA_TNUMBER)
+	{
+		auto value = lua_tonumber(L, 3);
+		for (auto i : ids)
+		{
+			if (i >= 0 && i < NPART && sim->parts[i].type)
+			{
+				SetNumericProperty(sim, prop, i, value);
+			}
+		}
+		return 0;
+	}
+	auto *buf = CheckPartBuffer(L, 3);
+	if (buf->values.size() != ids.size())
+	{
+		return luaL_error(L, "expected %d values, got %d", int(ids.size()), int(buf->values.size()));
+	}
+	for (int j = 0; j < int(ids.size()); ++j)
+	{
+		auto i = ids[j];
+		if (i >= 0 && i < NPART && sim->parts[i].type)
+		{
+			SetNumericProperty(sim, prop, i, buf->values[j]);
+		}
+	}
+	return 0;
+}
+
 static int partKill(lua_State *L)
 {
 	auto *lsi = GetLSI();
@@ -1100,6 +1481,58 @@ static int listStamps(lua_State *L)
 	return 1;
 }
 
+static int findStamps(lua_State *L)
+{
+	GetLSI()->AssertInterfaceEvent();
+	auto &client = Client::Ref();
+	auto query = StampIndex::Query::Parse(tpt_lua_checkByteString(L, 1));
+	auto stampIDs = client.GetStampIndex().Filter(client.GetStamps(), query);
+	lua_newtable(L);
+	auto i = 0;
+	for (auto &stampID : stampIDs)
+	{
+		tpt_lua_pushByteString(L, stampID);
+		i += 1;
+		lua_rawseti(L, -2, i);
+	}
+	return 1;
+}
+
+static int stampInfo(lua_State *L)
+{
+	GetLSI()->AssertInterfaceEvent();
+	auto *entry = Client::Ref().GetStampIndex().Get(tpt_lua_checkByteString(L, 1));
+	if (!entry)
+	{
+		return 0;
+	}
+	lua_newtable(L);
+	lua_pushinteger(L, entry->width);
+	lua_setfield(L, -2, "width");
+	lua_pushinteger(L, entry->height);
+	lua_setfield(L, -2, "height");
+	lua_pushinteger(L, entry->particleCount);
+	lua_setfield(L, -2, "particleCount");
+	lua_pushboolean(L, entry->newtonianGravity);
+	lua_setfield(L, -2, "newtonianGravity");
+	lua_pushboolean(L, entry->ambientHeat);
+	lua_setfield(L, -2, "ambientHeat");
+	lua_pushboolean(L, entry->legacyHeat);
+	lua_setfield(L, -2, "legacyHeat");
+	lua_pushboolean(L, entry->waterEqualisation);
+	lua_setfield(L, -2, "waterEqualisation");
+	lua_pushinteger(L, entry->airMode);
+	lua_setfield(L, -2, "airMode");
+	lua_newtable(L);
+	for (auto &[ identifier, count ] : entry->elements)
+	{
+		lua_pushinteger(L, count);
+		lua_setfield(L, -2, identifier.c_str());
+	}
+	lua_setfield(L, -2, "elements");
+	return 1;
+}
+
 static int loadSave(lua_State *L)
 {
 	auto *lsi = GetLSI();
@@ -1981,6 +2414,12 @@ void LuaSimulation::Open(lua_State *L)
 		LFUNC(partChangeType),
 		LFUNC(partCreate),
 		LFUNC(partProperty),
+		LFUNC(partFieldID),
+		LFUNC(partBuffer),
+		LFUNC(partIDs),
+		LFUNC(partPropertyGet),
+		LFUNC(partPropertyGetType),
+		LFUNC(partPropertySet),
 		LFUNC(partPosition),
 		LFUNC(partID),
 		LFUNC(partKill),
@@ -1989,6 +2428,9 @@ void LuaSimulation::Open(lua_State *L)
 		LFUNC(ambientHeat),
 		LFUNC(ambientHeatSim),
 		LFUNC(heatSim),
+		LFUNC(sleepingRegions),
+		LFUNC(gridHeat),
+		LFUNC(serialBeforeSim),
 		LFUNC(newtonianGravity),
 		LFUNC(velocityX),
 		LFUNC(velocityY),
@@ -2016,6 +2458,8 @@ void LuaSimulation::Open(lua_State *L)
 		LFUNC(loadStamp),
 		LFUNC(deleteStamp),
 		LFUNC(listStamps),
+		LFUNC(findStamps),
+		LFUNC(stampInfo),
 		LFUNC(loadSave),
 		LFUNC(reloadSave),
 		LFUNC(getSaveID),
@@ -2067,6 +2511,28 @@ void LuaSimulation::Open(lua_State *L)
 #undef LFUNC
 		{ nullptr, nullptr }
 	};
+	luaL_newmetatable(L, PartBuffer::className);
+	lua_pushcfunction(L, partBufferGC);
+	lua_setfield(L, -2, "__gc");
+	lua_pushcfunction(L, partBufferSize);
+	lua_setfield(L, -2, "__len");
+	lua_pushcfunction(L, partBufferNewIndex);
+	lua_setfield(L, -2, "__newindex");
+	{
+		static const luaL_Reg partBufferMethods[] = {
+			{   "size", partBufferSize   },
+			{ "resize", partBufferResize },
+			{   "fill", partBufferFill   },
+			{  "table", partBufferTable  },
+			{  nullptr, nullptr          },
+		};
+		lua_newtable(L);
+		luaL_register(L, nullptr, partBufferMethods);
+		lua_pushcclosure(L, partBufferIndex, 1);
+		lua_setfield(L, -2, "__index");
+	}
+	lua_pop(L, 1);
+
 	lua_newtable(L);
 	luaL_register(L, nullptr, reg);
 
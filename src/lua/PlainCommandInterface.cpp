@@ -23,11 +23,20 @@ bool CommandInterface::HandleEvent(const GameControllerEvent &event)
 	return true;
 }
 
+void CommandInterface::FlushCustomElementBatches()
+{
+}
+
 bool CommandInterface::HaveSimGraphicsEventHandlers()
 {
 	return false;
 }
 
+bool CommandInterface::HaveSimulationCallbacks()
+{
+	return false;
+}
+
 int CommandInterface::Command(String command)
 {
 	return PlainCommand(command);
@@ -2,9 +2,29 @@
 #include "Simulation.h"
 #include "ElementClasses.h"
 #include "common/tpt-rand.h"
+#include "common/TaskGraph.h"
 #include <cmath>
 #include <algorithm>
 
+namespace
+{
+	// Adds one task per band of rows that runs pass on that band, after all of
+	// previous. Returns the new tasks, for the next pass to wait on.
+	std::vector<TaskGraph::TaskId> AddBandedPass(TaskGraph &graph, int bandCount, std::vector<TaskGraph::TaskId> previous, std::function<void (int, int)> pass)
+	{
+		std::vector<TaskGraph::TaskId> bands;
+		for (auto band = 0; band < bandCount; band++)
+		{
+			auto y0 = YCELLS * band / bandCount;
+			auto y1 = YCELLS * (band + 1) / bandCount;
+			bands.push_back(graph.Add([pass, y0, y1]() {
+				pass(y0, y1);
+			}, previous));
+		}
+		return bands;
+	}
+}
+
 void Air::make_kernel(void) //used for velocity
 {
 	float s = 0.0f;
@@ -77,8 +97,11 @@ const float advDistanceMult = 0.7f;
 
 void Air::update_airh(void)
 {
-	auto &vx = sim.vx;
-	auto &vy = sim.vy;
+	airhTasks->Run(!sim.serialBeforeSim);
+}
+
+void Air::ResetAirHEdges()
+{
 	auto &hv = sim.hv;
 	for (auto i=0; i<YCELLS; i++) //sets air temp on the edges every frame
 	{
@@ -94,7 +117,65 @@ void Air::update_airh(void)
 		hv[YCELLS-2][i] = ambientAirTemp;
 		hv[YCELLS-1][i] = ambientAirTemp;
 	}
-	for (auto y=0; y<YCELLS; y++) //update air temp and velocity
+}
+
+void Air::ConvectAirH(int y0, int y1)
+{
+	auto &vx = sim.vx;
+	auto &vy = sim.vy;
+	auto &hv = sim.hv;
+	for (auto y=y0; y<y1; y++) //update air velocity
+	{
+		for (auto x=0; x<XCELLS; x++)
+		{
+			// Air convection.
+			// We use the Boussinesq approximation, i.e. we assume density to be nonconstant only
+			// near the gravity term of the fluid equation, and we suppose that it depends linearly on the
+			// difference between the current temperature (hv[y][x]) and some "stationary" temperature (ambientAirTemp).
+			float dvx, dvy;
+			dvx = vx[y][x];
+		       	dvy = vy[y][x];
+
+			if (x>=2 && x<XCELLS-2 && y>=2 && y<YCELLS-2)
+			{
+				float convGravX, convGravY;
+				sim.GetGravityField(x*CELL, y*CELL, -1.0f, -1.0f, convGravX, convGravY);
+
+				// Cap the gravity field
+				float gravMagn = std::sqrt(convGravX*convGravX + convGravY*convGravY);
+				if (gravMagn > 10.0f)
+				{
+					convGravX /= 0.1f*gravMagn;
+					convGravY /= 0.1f*gravMagn;
+				}
+
+				auto weight = (hv[y][x] - ambientAirTemp) / 10000.0f;
+
+				// Our approximation works best when the temperature difference is small, so we cap it from above.
+				if (weight > 0.01f) weight = 0.01f;
+
+				dvx += weight * convGravX;
+				dvy += weight * convGravY;
+			}
+
+			// Velocity cap
+			if (dvx > MAX_PRESSURE) dvx = MAX_PRESSURE;
+			if (dvx < MIN_PRESSURE) dvx = MIN_PRESSURE;
+			if (dvy > MAX_PRESSURE) dvy = MAX_PRESSURE;
+			if (dvy < MIN_PRESSURE) dvy = MIN_PRESSURE;
+
+			ovx[y][x] = dvx;
+			ovy[y][x] = dvy;
+		}
+	}
+}
+
+void Air::AdvectAirH(int y0, int y1)
+{
+	auto &vx = sim.vx;
+	auto &vy = sim.vy;
+	auto &hv = sim.hv;
+	for (auto y=y0; y<y1; y++) //update air temp
 	{
 		for (auto x=0; x<XCELLS; x++)
 		{
@@ -108,9 +189,11 @@ void Air::update_airh(void)
 					if (y+j > 0 && y+j < YCELLS-1 && x+i > 0 && x+i < XCELLS-1 && !(bmap_blockairh[y+j][x+i]&0x8))
 					{
 						auto f = kernel[i+1+(j+1)*3];
+						// * Cells before this one in row order already have their new velocities.
+						auto updated = j < 0 || (j == 0 && i < 0);
 						dh += hv[y+j][x+i]*f;
-						dx += vx[y+j][x+i]*f;
-						dy += vy[y+j][x+i]*f;
+						dx += (updated ? ovx : vx)[y+j][x+i]*f;
+						dy += (updated ? ovy : vy)[y+j][x+i]*f;
 					}
 					else
 					{
@@ -186,379 +269,390 @@ void Air::update_airh(void)
 			if (dh < MIN_TEMP) dh = MIN_TEMP;
 
 			ohv[y][x] = dh;
+		}
+	}
+}
 
-			// Air convection.
-			// We use the Boussinesq approximation, i.e. we assume density to be nonconstant only
-			// near the gravity term of the fluid equation, and we suppose that it depends linearly on the
-			// difference between the current temperature (hv[y][x]) and some "stationary" temperature (ambientAirTemp).
-			float dvx, dvy;
-			dvx = vx[y][x];
-		       	dvy = vy[y][x];
-
-			if (x>=2 && x<XCELLS-2 && y>=2 && y<YCELLS-2)
-			{
-				float convGravX, convGravY;
-				sim.GetGravityField(x*CELL, y*CELL, -1.0f, -1.0f, convGravX, convGravY);
-
-				// Cap the gravity field
-				float gravMagn = std::sqrt(convGravX*convGravX + convGravY*convGravY);
-				if (gravMagn > 10.0f)
-				{
-					convGravX /= 0.1f*gravMagn;
-					convGravY /= 0.1f*gravMagn;
-				}
+void Air::CopyAirH(int y0, int y1)
+{
+	std::copy(&ohv[0][0] + y0*XCELLS, &ohv[0][0] + y1*XCELLS, &sim.hv[0][0] + y0*XCELLS);
+	std::copy(&ovx[0][0] + y0*XCELLS, &ovx[0][0] + y1*XCELLS, &sim.vx[0][0] + y0*XCELLS);
+	std::copy(&ovy[0][0] + y0*XCELLS, &ovy[0][0] + y1*XCELLS, &sim.vy[0][0] + y0*XCELLS);
+}
 
-				auto weight = (hv[y][x] - ambientAirTemp) / 10000.0f;
+void Air::update_air(void)
+{
+	if (airMode != AIR_NOUPDATE) //airMode 4 is no air/pressure update
+	{
+		airTasks->Run(!sim.serialBeforeSim);
+	}
+}
 
-				// Our approximation works best when the temperature difference is small, so we cap it from above.
-				if (weight > 0.01f) weight = 0.01f;
+void Air::DampAirEdges()
+{
+	auto &vx = sim.vx;
+	auto &vy = sim.vy;
+	auto &pv = sim.pv;
+	for (auto i=0; i<YCELLS; i++) //reduces pressure/velocity on the edges every frame
+	{
+		pv[i][0] = pv[i][0]*0.8f;
+		pv[i][1] = pv[i][1]*0.8f;
+		pv[i][XCELLS-2] = pv[i][XCELLS-2]*0.8f;
+		pv[i][XCELLS-1] = pv[i][XCELLS-1]*0.8f;
+		vx[i][0] = vx[i][0]*0.9f;
+		vx[i][1] = vx[i][1]*0.9f;
+		vx[i][XCELLS-2] = vx[i][XCELLS-2]*0.9f;
+		vx[i][XCELLS-1] = vx[i][XCELLS-1]*0.9f;
+		vy[i][0] = vy[i][0]*0.9f;
+		vy[i][1] = vy[i][1]*0.9f;
+		vy[i][XCELLS-2] = vy[i][XCELLS-2]*0.9f;
+		vy[i][XCELLS-1] = vy[i][XCELLS-1]*0.9f;
+	}
+	for (auto i=0; i<XCELLS; i++) //reduces pressure/velocity on the edges every frame
+	{
+		pv[0][i] = pv[0][i]*0.8f;
+		pv[1][i] = pv[1][i]*0.8f;
+		pv[YCELLS-2][i] = pv[YCELLS-2][i]*0.8f;
+		pv[YCELLS-1][i] = pv[YCELLS-1][i]*0.8f;
+		vx[0][i] = vx[0][i]*0.9f;
+		vx[1][i] = vx[1][i]*0.9f;
+		vx[YCELLS-2][i] = vx[YCELLS-2][i]*0.9f;
+		vx[YCELLS-1][i] = vx[YCELLS-1][i]*0.9f;
+		vy[0][i] = vy[0][i]*0.9f;
+		vy[1][i] = vy[1][i]*0.9f;
+		vy[YCELLS-2][i] = vy[YCELLS-2][i]*0.9f;
+		vy[YCELLS-1][i] = vy[YCELLS-1][i]*0.9f;
+	}
+}
 
-				dvx += weight * convGravX;
-				dvy += weight * convGravY;
+void Air::ClearWallVelocities(int y0, int y1)
+{
+	auto &vx = sim.vx;
+	auto &vy = sim.vy;
+	// clear some velocities near walls; gathers rather than scatters so that a band
+	// only writes its own rows
+	for (auto y=y0; y<y1; y++)
+	{
+		for (auto x=0; x<XCELLS; x++)
+		{
+			auto blockX = false;
+			auto blockY = false;
+			for (auto d=-1; d<2; d++)
+			{
+				if (y>0 && y<YCELLS-1 && x+d>0 && x+d<XCELLS-1 && bmap_blockair[y][x+d])
+					blockX = true;
+				if (x>0 && x<XCELLS-1 && y+d>0 && y+d<YCELLS-1 && bmap_blockair[y+d][x])
+					blockY = true;
 			}
+			if (blockX)
+				vx[y][x] = 0.0f;
+			if (blockY)
+				vy[y][x] = 0.0f;
+		}
+	}
+}
 
-			// Velocity cap
-			if (dvx > MAX_PRESSURE) dvx = MAX_PRESSURE;
-			if (dvx < MIN_PRESSURE) dvx = MIN_PRESSURE;
-			if (dvy > MAX_PRESSURE) dvy = MAX_PRESSURE;
-			if (dvy < MIN_PRESSURE) dvy = MIN_PRESSURE;
+void Air::UpdateDensity(int y0, int y1)
+{
+	auto &vx = sim.vx;
+	auto &vy = sim.vy;
+	// Update density using continuity equation: ∂ρ/∂t + ∇·(ρv) = 0
+	// For compressible flow: ∂ρ/∂t = -∇·(ρv) ≈ -ρ∇·v (advection handled by existing code)
+	const float dt = AIR_TSTEPP;
 
-			vx[y][x] = dvx;
-			vy[y][x] = dvy;
+	for (auto y=std::max(y0, 1); y<std::min(y1, YCELLS-1); y++)
+	{
+		for (auto x=1; x<XCELLS-1; x++)
+		{
+			if (!bmap_blockair[y][x])
+			{
+				// Calculate velocity divergence: ∇·v = ∂vx/∂x + ∂vy/∂y
+				float div_v = (vx[y][x+1] - vx[y][x-1]) + (vy[y+1][x] - vy[y-1][x]);
+				
+				// Update density: ∂ρ/∂t = -ρ∇·v
+				// When fluid compresses (div_v < 0), density increases
+				// When fluid expands (div_v > 0), density decreases
+				rho[y][x] -= rho[y][x] * div_v * dt;
+				
+				// Clamp density to prevent negative or extreme values
+				if (rho[y][x] < 0.01f) rho[y][x] = 0.01f;
+				if (rho[y][x] > 10.0f) rho[y][x] = 10.0f;
+			}
 		}
 	}
-	memcpy(hv, ohv, sizeof(hv));
 }
 
-void Air::update_air(void)
+void Air::UpdatePressure(int y0, int y1)
 {
 	auto &vx = sim.vx;
 	auto &vy = sim.vy;
 	auto &pv = sim.pv;
 	auto &hv = sim.hv;
-	auto &fvx = sim.fvx;
-	auto &fvy = sim.fvy;
-	auto &bmap = sim.bmap;
-	if (airMode != AIR_NOUPDATE) //airMode 4 is no air/pressure update
-	{
-		for (auto i=0; i<YCELLS; i++) //reduces pressure/velocity on the edges every frame
-		{
-			pv[i][0] = pv[i][0]*0.8f;
-			pv[i][1] = pv[i][1]*0.8f;
-			pv[i][XCELLS-2] = pv[i][XCELLS-2]*0.8f;
-			pv[i][XCELLS-1] = pv[i][XCELLS-1]*0.8f;
-			vx[i][0] = vx[i][0]*0.9f;
-			vx[i][1] = vx[i][1]*0.9f;
-			vx[i][XCELLS-2] = vx[i][XCELLS-2]*0.9f;
-			vx[i][XCELLS-1] = vx[i][XCELLS-1]*0.9f;
-			vy[i][0] = vy[i][0]*0.9f;
-			vy[i][1] = vy[i][1]*0.9f;
-			vy[i][XCELLS-2] = vy[i][XCELLS-2]*0.9f;
-			vy[i][XCELLS-1] = vy[i][XCELLS-1]*0.9f;
-		}
-		for (auto i=0; i<XCELLS; i++) //reduces pressure/velocity on the edges every frame
-		{
-			pv[0][i] = pv[0][i]*0.8f;
-			pv[1][i] = pv[1][i]*0.8f;
-			pv[YCELLS-2][i] = pv[YCELLS-2][i]*0.8f;
-			pv[YCELLS-1][i] = pv[YCELLS-1][i]*0.8f;
-			vx[0][i] = vx[0][i]*0.9f;
-			vx[1][i] = vx[1][i]*0.9f;
-			vx[YCELLS-2][i] = vx[YCELLS-2][i]*0.9f;
-			vx[YCELLS-1][i] = vx[YCELLS-1][i]*0.9f;
-			vy[0][i] = vy[0][i]*0.9f;
-			vy[1][i] = vy[1][i]*0.9f;
-			vy[YCELLS-2][i] = vy[YCELLS-2][i]*0.9f;
-			vy[YCELLS-1][i] = vy[YCELLS-1][i]*0.9f;
-		}
+	// Update pressure using pressure evolution equation for compressible flow
+	// From ideal gas law and continuity: ∂P/∂t = -v·∇P - γP∇·v
+	// We use a hybrid approach: evolve pressure naturally, but keep it close to ideal gas law
+	const float P_atm = 101325.0f; // Standard atmospheric pressure (Pa)
+	const float P_scale = MAX_PRESSURE / P_atm; // Scale factor: game units per Pa
+	const float R_gas = 287.0f; // Specific gas constant for air (J/(kg·K))
+	const float gamma = 1.4f; // Adiabatic index for air (cp/cv)
+	const float dt = AIR_TSTEPP;
 
-		for (auto j=1; j<YCELLS-1; j++) //clear some velocities near walls
+	for (auto y=std::max(y0, 1); y<std::min(y1, YCELLS-1); y++)
+	{
+		for (auto x=1; x<XCELLS-1; x++)
 		{
-			for (auto i=1; i<XCELLS-1; i++)
+			if (!bmap_blockair[y][x])
 			{
-				if (bmap_blockair[j][i])
+				// Get temperature from ambient heat field (in Kelvin)
+				float T = hv[y][x];
+				if (T < 0.0f) T = ambientAirTemp;
+				
+				// Ideal gas law: P = ρRT (what pressure should be)
+				float P_pa_ideal = rho[y][x] * R_gas * T;
+				
+				// Get current pressure in Pa (convert from game units)
+				float P_pa_current;
+				if (useAtmosphericPressure)
+				{
+					P_pa_current = pv[y][x] / P_scale + P_atm;
+				}
+				else
+				{
+					P_pa_current = pv[y][x] / P_scale;
+				}
+				
+				// Calculate velocity divergence
+				float div_v = (vx[y][x+1] - vx[y][x-1]) + (vy[y+1][x] - vy[y-1][x]);
+				
+				// Pressure evolution: ∂P/∂t = -γP∇·v (compressible flow)
+				// This naturally evolves pressure based on compression/expansion
+				float P_pa_evolved = P_pa_current - gamma * P_pa_current * div_v * dt;
+				
+				// Blend evolved pressure with ideal gas law
+				// Use a small correction to keep pressure close to ideal gas law
+				// This prevents drift while allowing natural evolution
+				const float ideal_correction = 0.02f; // Very small correction for stability
+				float P_pa_new = P_pa_evolved * (1.0f - ideal_correction) + P_pa_ideal * ideal_correction;
+				
+				// Ensure pressure doesn't go negative
+				if (P_pa_new < 100.0f) P_pa_new = 100.0f; // Minimum 100 Pa
+				
+				// Convert back to game units
+				float P_game;
+				if (useAtmosphericPressure)
 				{
-					vx[j][i] = 0.0f;
-					vx[j][i-1] = 0.0f;
-					vx[j][i+1] = 0.0f;
-					vy[j][i] = 0.0f;
-					vy[j-1][i] = 0.0f;
-					vy[j+1][i] = 0.0f;
+					P_game = (P_pa_new - P_atm) * P_scale;
 				}
+				else
+				{
+					P_game = P_pa_new * P_scale;
+				}
+				
+				// Apply damping and update pressure gradually
+				// Use very gradual update to prevent instability from large pressure differences
+				pv[y][x] *= AIR_PLOSS;
+				float pressure_diff = P_game - pv[y][x];
+				// Limit the maximum pressure change per frame to prevent explosions
+				const float max_change = 2.0f; // Maximum pressure change per frame
+				if (pressure_diff > max_change) pressure_diff = max_change;
+				if (pressure_diff < -max_change) pressure_diff = -max_change;
+				pv[y][x] += pressure_diff * AIR_TSTEPP * 0.3f; // Even slower update for stability
+				
+				// Clamp to game pressure limits
+				if (pv[y][x] > MAX_PRESSURE) pv[y][x] = MAX_PRESSURE;
+				if (pv[y][x] < MIN_PRESSURE) pv[y][x] = MIN_PRESSURE;
 			}
 		}
+	}
+}
 
-		// Update density using continuity equation: ∂ρ/∂t + ∇·(ρv) = 0
-		// For compressible flow: ∂ρ/∂t = -∇·(ρv) ≈ -ρ∇·v (advection handled by existing code)
-		const float R_gas = 287.0f; // Specific gas constant for air (J/(kg·K))
-		const float gamma = 1.4f; // Adiabatic index for air (cp/cv)
-		const float dt = AIR_TSTEPP;
-		
-		for (auto y=1; y<YCELLS-1; y++)
+void Air::ApplyPressureGradient(int y0, int y1)
+{
+	auto &vx = sim.vx;
+	auto &vy = sim.vy;
+	auto &pv = sim.pv;
+	for (auto y=std::max(y0, 1); y<std::min(y1, YCELLS-1); y++) //velocity adjustments from pressure
+	{
+		for (auto x=1; x<XCELLS-1; x++)
 		{
-			for (auto x=1; x<XCELLS-1; x++)
-			{
-				if (!bmap_blockair[y][x])
-				{
-					// Calculate velocity divergence: ∇·v = ∂vx/∂x + ∂vy/∂y
-					float div_v = (vx[y][x+1] - vx[y][x-1]) + (vy[y+1][x] - vy[y-1][x]);
-					
-					// Update density: ∂ρ/∂t = -ρ∇·v
-					// When fluid compresses (div_v < 0), density increases
-					// When fluid expands (div_v > 0), density decreases
-					rho[y][x] -= rho[y][x] * div_v * dt;
-					
-					// Clamp density to prevent negative or extreme values
-					if (rho[y][x] < 0.01f) rho[y][x] = 0.01f;
-					if (rho[y][x] > 10.0f) rho[y][x] = 10.0f;
-				}
-			}
+			auto dx = 0.0f;
+			auto dy = 0.0f;
+			dx += pv[y][x-1] - pv[y][x+1];
+			dy += pv[y-1][x] - pv[y+1][x];
+			vx[y][x] *= AIR_VLOSS;
+			vy[y][x] *= AIR_VLOSS;
+			vx[y][x] += dx*AIR_TSTEPV * 0.5f;
+			vy[y][x] += dy*AIR_TSTEPV * 0.5f;
+			if (bmap_blockair[y][x-1] || bmap_blockair[y][x] || bmap_blockair[y][x+1])
+				vx[y][x] = 0;
+			if (bmap_blockair[y-1][x] || bmap_blockair[y][x] || bmap_blockair[y+1][x])
+				vy[y][x] = 0;
 		}
-		
-		// Update pressure using pressure evolution equation for compressible flow
-		// From ideal gas law and continuity: ∂P/∂t = -v·∇P - γP∇·v
-		// We use a hybrid approach: evolve pressure naturally, but keep it close to ideal gas law
-		const float P_atm = 101325.0f; // Standard atmospheric pressure (Pa)
-		const float P_scale = MAX_PRESSURE / P_atm; // Scale factor: game units per Pa
-		
-		for (auto y=1; y<YCELLS-1; y++)
+	}
+}
+
+void Air::AdvectAir(int y0, int y1)
+{
+	auto &vx = sim.vx;
+	auto &vy = sim.vy;
+	auto &pv = sim.pv;
+	auto &fvx = sim.fvx;
+	auto &fvy = sim.fvy;
+	auto &bmap = sim.bmap;
+	for (auto y=y0; y<y1; y++) //update velocity and pressure
+	{
+		for (auto x=0; x<XCELLS; x++)
 		{
-			for (auto x=1; x<XCELLS-1; x++)
+			auto dx = 0.0f;
+			auto dy = 0.0f;
+			auto dp = 0.0f;
+			for (auto j=-1; j<2; j++)
 			{
-				if (!bmap_blockair[y][x])
+				for (auto i=-1; i<2; i++)
 				{
-					// Get temperature from ambient heat field (in Kelvin)
-					float T = hv[y][x];
-					if (T < 0.0f) T = ambientAirTemp;
-					
-					// Ideal gas law: P = ρRT (what pressure should be)
-					float P_pa_ideal = rho[y][x] * R_gas * T;
-					
-					// Get current pressure in Pa (convert from game units)
-					float P_pa_current;
-					if (useAtmosphericPressure)
+					if (y+j>0 && y+j<YCELLS-1 &&
+					        x+i>0 && x+i<XCELLS-1 &&
+					        !bmap_blockair[y+j][x+i])
 					{
-						P_pa_current = pv[y][x] / P_scale + P_atm;
-					}
-					else
-					{
-						P_pa_current = pv[y][x] / P_scale;
-					}
-					
-					// Calculate velocity divergence
-					float div_v = (vx[y][x+1] - vx[y][x-1]) + (vy[y+1][x] - vy[y-1][x]);
-					
-					// Pressure evolution: ∂P/∂t = -γP∇·v (compressible flow)
-					// This naturally evolves pressure based on compression/expansion
-					float P_pa_evolved = P_pa_current - gamma * P_pa_current * div_v * dt;
-					
-					// Blend evolved pressure with ideal gas law
-					// Use a small correction to keep pressure close to ideal gas law
-					// This prevents drift while allowing natural evolution
-					const float ideal_correction = 0.02f; // Very small correction for stability
-					float P_pa_new = P_pa_evolved * (1.0f - ideal_correction) + P_pa_ideal * ideal_correction;
-					
-					// Ensure pressure doesn't go negative
-					if (P_pa_new < 100.0f) P_pa_new = 100.0f; // Minimum 100 Pa
-					
-					// Convert back to game units
-					float P_game;
-					if (useAtmosphericPressure)
-					{
-						P_game = (P_pa_new - P_atm) * P_scale;
+						auto f = kernel[i+1+(j+1)*3];
+						dx += vx[y+j][x+i]*f;
+						dy += vy[y+j][x+i]*f;
+						dp += pv[y+j][x+i]*f;
 					}
 					else
 					{
-						P_game = P_pa_new * P_scale;
+						auto f = kernel[i+1+(j+1)*3];
+						dx += vx[y][x]*f;
+						dy += vy[y][x]*f;
+						dp += pv[y][x]*f;
 					}
-					
-					// Apply damping and update pressure gradually
-					// Use very gradual update to prevent instability from large pressure differences
-					pv[y][x] *= AIR_PLOSS;
-					float pressure_diff = P_game - pv[y][x];
-					// Limit the maximum pressure change per frame to prevent explosions
-					const float max_change = 2.0f; // Maximum pressure change per frame
-					if (pressure_diff > max_change) pressure_diff = max_change;
-					if (pressure_diff < -max_change) pressure_diff = -max_change;
-					pv[y][x] += pressure_diff * AIR_TSTEPP * 0.3f; // Even slower update for stability
-					
-					// Clamp to game pressure limits
-					if (pv[y][x] > MAX_PRESSURE) pv[y][x] = MAX_PRESSURE;
-					if (pv[y][x] < MIN_PRESSURE) pv[y][x] = MIN_PRESSURE;
 				}
 			}
-		}
-
-		for (auto y=1; y<YCELLS-1; y++) //velocity adjustments from pressure
-		{
-			for (auto x=1; x<XCELLS-1; x++)
-			{
-				auto dx = 0.0f;
-				auto dy = 0.0f;
-				dx += pv[y][x-1] - pv[y][x+1];
-				dy += pv[y-1][x] - pv[y+1][x];
-				vx[y][x] *= AIR_VLOSS;
-				vy[y][x] *= AIR_VLOSS;
-				vx[y][x] += dx*AIR_TSTEPV * 0.5f;
-				vy[y][x] += dy*AIR_TSTEPV * 0.5f;
-				if (bmap_blockair[y][x-1] || bmap_blockair[y][x] || bmap_blockair[y][x+1])
-					vx[y][x] = 0;
-				if (bmap_blockair[y-1][x] || bmap_blockair[y][x] || bmap_blockair[y+1][x])
-					vy[y][x] = 0;
-			}
-		}
 
-		for (auto y=0; y<YCELLS; y++) //update velocity and pressure
-		{
-			for (auto x=0; x<XCELLS; x++)
+			auto tx = x - dx*advDistanceMult;
+			auto ty = y - dy*advDistanceMult;
+			if ((std::abs(dx*advDistanceMult)>1.0f || std::abs(dy*advDistanceMult)>1.0f) && (tx>=2 && tx<XCELLS-2 && ty>=2 && ty<YCELLS-2))
 			{
-				auto dx = 0.0f;
-				auto dy = 0.0f;
-				auto dp = 0.0f;
-				for (auto j=-1; j<2; j++)
+				// Trying to take velocity from far away, check whether there is an intervening wall.
+				// Step from current position to desired source location, looking for walls, with either the x or y step size being 1 cell
+				float stepX, stepY;
+				int stepLimit;
+				if (std::abs(dx)>std::abs(dy))
 				{
-					for (auto i=-1; i<2; i++)
-					{
-						if (y+j>0 && y+j<YCELLS-1 &&
-						        x+i>0 && x+i<XCELLS-1 &&
-						        !bmap_blockair[y+j][x+i])
-						{
-							auto f = kernel[i+1+(j+1)*3];
-							dx += vx[y+j][x+i]*f;
-							dy += vy[y+j][x+i]*f;
-							dp += pv[y+j][x+i]*f;
-						}
-						else
-						{
-							auto f = kernel[i+1+(j+1)*3];
-							dx += vx[y][x]*f;
-							dy += vy[y][x]*f;
-							dp += pv[y][x]*f;
-						}
-					}
+					stepX = (dx<0.0f) ? 1.f : -1.f;
+					stepY = -dy/fabsf(dx);
+					stepLimit = (int)(fabsf(dx*advDistanceMult));
 				}
-
-				auto tx = x - dx*advDistanceMult;
-				auto ty = y - dy*advDistanceMult;
-				if ((std::abs(dx*advDistanceMult)>1.0f || std::abs(dy*advDistanceMult)>1.0f) && (tx>=2 && tx<XCELLS-2 && ty>=2 && ty<YCELLS-2))
+				else
 				{
-					// Trying to take velocity from far away, check whether there is an intervening wall.
-					// Step from current position to desired source location, looking for walls, with either the x or y step size being 1 cell
-					float stepX, stepY;
-					int stepLimit;
-					if (std::abs(dx)>std::abs(dy))
-					{
-						stepX = (dx<0.0f) ? 1.f : -1.f;
-						stepY = -dy/fabsf(dx);
-						stepLimit = (int)(fabsf(dx*advDistanceMult));
-					}
-					else
-					{
-						stepY = (dy<0.0f) ? 1.f : -1.f;
-						stepX = -dx/fabsf(dy);
-						stepLimit = (int)(fabsf(dy*advDistanceMult));
-					}
-					tx = float(x);
-					ty = float(y);
-					auto step = 0;
-					for (; step<stepLimit; ++step)
-					{
-						tx += stepX;
-						ty += stepY;
-						if (bmap_blockair[(int)(ty+0.5f)][(int)(tx+0.5f)])
-						{
-							tx -= stepX;
-							ty -= stepY;
-							break;
-						}
-					}
-					if (step==stepLimit)
+					stepY = (dy<0.0f) ? 1.f : -1.f;
+					stepX = -dx/fabsf(dy);
+					stepLimit = (int)(fabsf(dy*advDistanceMult));
+				}
+				tx = float(x);
+				ty = float(y);
+				auto step = 0;
+				for (; step<stepLimit; ++step)
+				{
+					tx += stepX;
+					ty += stepY;
+					if (bmap_blockair[(int)(ty+0.5f)][(int)(tx+0.5f)])
 					{
-						// No wall found
-						tx = x - dx*advDistanceMult;
-						ty = y - dy*advDistanceMult;
+						tx -= stepX;
+						ty -= stepY;
+						break;
 					}
 				}
-				auto i = (int)tx;
-				auto j = (int)ty;
-				tx -= i;
-				ty -= j;
-				if (!bmap_blockair[y][x] && i>=2 && i<XCELLS-3 && j>=2 && j<YCELLS-3)
+				if (step==stepLimit)
 				{
-					dx *= 1.0f - AIR_VADV;
-					dy *= 1.0f - AIR_VADV;
-
-					dx += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vx[j][i];
-					dy += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vy[j][i];
+					// No wall found
+					tx = x - dx*advDistanceMult;
+					ty = y - dy*advDistanceMult;
+				}
+			}
+			auto i = (int)tx;
+			auto j = (int)ty;
+			tx -= i;
+			ty -= j;
+			if (!bmap_blockair[y][x] && i>=2 && i<XCELLS-3 && j>=2 && j<YCELLS-3)
+			{
+				dx *= 1.0f - AIR_VADV;
+				dy *= 1.0f - AIR_VADV;
 
-					dx += AIR_VADV*tx*(1.0f-ty)*vx[j][i+1];
-					dy += AIR_VADV*tx*(1.0f-ty)*vy[j][i+1];
+				dx += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vx[j][i];
+				dy += AIR_VADV*(1.0f-tx)*(1.0f-ty)*vy[j][i];
 
-					dx += AIR_VADV*(1.0f-tx)*ty*vx[j+1][i];
-					dy += AIR_VADV*(1.0f-tx)*ty*vy[j+1][i];
+				dx += AIR_VADV*tx*(1.0f-ty)*vx[j][i+1];
+				dy += AIR_VADV*tx*(1.0f-ty)*vy[j][i+1];
 
-					dx += AIR_VADV*tx*ty*vx[j+1][i+1];
-					dy += AIR_VADV*tx*ty*vy[j+1][i+1];
-				}
+				dx += AIR_VADV*(1.0f-tx)*ty*vx[j+1][i];
+				dy += AIR_VADV*(1.0f-tx)*ty*vy[j+1][i];
 
-				//Vorticity confinement
-				if (vorticityCoeff > 0.0f && x > 1 && x < XCELLS-2 && y > 1 && y < YCELLS-2)
-				{
-					auto dwx = (std::abs(vorticity(sim, y, x+1)) - std::abs(vorticity(sim, y, x-1)))*0.5f;
-					auto dwy = (std::abs(vorticity(sim, y+1, x)) - std::abs(vorticity(sim, y-1, x)))*0.5f;
-					auto norm = std::sqrt(dwx*dwx + dwy*dwy);
-					auto w = vorticity(sim, y, x);
+				dx += AIR_VADV*tx*ty*vx[j+1][i+1];
+				dy += AIR_VADV*tx*ty*vy[j+1][i+1];
+			}
 
-					dx += vorticityCoeff/5.0f * dwy / (norm + 0.001f) * w;
-					dy += vorticityCoeff/5.0f * (-dwx) / (norm + 0.001f) * w;
-				}
+			//Vorticity confinement
+			if (vorticityCoeff > 0.0f && x > 1 && x < XCELLS-2 && y > 1 && y < YCELLS-2)
+			{
+				auto dwx = (std::abs(vorticity(sim, y, x+1)) - std::abs(vorticity(sim, y, x-1)))*0.5f;
+				auto dwy = (std::abs(vorticity(sim, y+1, x)) - std::abs(vorticity(sim, y-1, x)))*0.5f;
+				auto norm = std::sqrt(dwx*dwx + dwy*dwy);
+				auto w = vorticity(sim, y, x);
 
-				if (bmap[y][x] == WL_FAN)
-				{
-					dx += fvx[y][x];
-					dy += fvy[y][x];
-				}
-				// pressure/velocity caps
-				if (dp > MAX_PRESSURE) dp = MAX_PRESSURE;
-				if (dp < MIN_PRESSURE) dp = MIN_PRESSURE;
-				if (dx > MAX_PRESSURE) dx = MAX_PRESSURE;
-				if (dx < MIN_PRESSURE) dx = MIN_PRESSURE;
-				if (dy > MAX_PRESSURE) dy = MAX_PRESSURE;
-				if (dy < MIN_PRESSURE) dy = MIN_PRESSURE;
+				dx += vorticityCoeff/5.0f * dwy / (norm + 0.001f) * w;
+				dy += vorticityCoeff/5.0f * (-dwx) / (norm + 0.001f) * w;
+			}
 
+			if (bmap[y][x] == WL_FAN)
+			{
+				dx += fvx[y][x];
+				dy += fvy[y][x];
+			}
+			// pressure/velocity caps
+			if (dp > MAX_PRESSURE) dp = MAX_PRESSURE;
+			if (dp < MIN_PRESSURE) dp = MIN_PRESSURE;
+			if (dx > MAX_PRESSURE) dx = MAX_PRESSURE;
+			if (dx < MIN_PRESSURE) dx = MIN_PRESSURE;
+			if (dy > MAX_PRESSURE) dy = MAX_PRESSURE;
+			if (dy < MIN_PRESSURE) dy = MIN_PRESSURE;
 
-				switch (airMode)
-				{
-				default:
-				case AIR_ON:  //Default
-					break;
-				case AIR_PRESSUREOFF:  //0 Pressure
-					dp = 0.0f;
-					break;
-				case AIR_VELOCITYOFF:  //0 Velocity
-					dx = 0.0f;
-					dy = 0.0f;
-					break;
-				case AIR_OFF: //0 Air
-					dx = 0.0f;
-					dy = 0.0f;
-					dp = 0.0f;
-					break;
-				case AIR_NOUPDATE: //No Update
-					break;
-				}
 
-				ovx[y][x] = dx;
-				ovy[y][x] = dy;
-				opv[y][x] = dp;
+			switch (airMode)
+			{
+			default:
+			case AIR_ON:  //Default
+				break;
+			case AIR_PRESSUREOFF:  //0 Pressure
+				dp = 0.0f;
+				break;
+			case AIR_VELOCITYOFF:  //0 Velocity
+				dx = 0.0f;
+				dy = 0.0f;
+				break;
+			case AIR_OFF: //0 Air
+				dx = 0.0f;
+				dy = 0.0f;
+				dp = 0.0f;
+				break;
+			case AIR_NOUPDATE: //No Update
+				break;
 			}
+
+			ovx[y][x] = dx;
+			ovy[y][x] = dy;
+			opv[y][x] = dp;
 		}
-		memcpy(vx, ovx, sizeof(vx));
-		memcpy(vy, ovy, sizeof(vy));
-		memcpy(pv, opv, sizeof(pv));
 	}
 }
 
+void Air::CopyAir(int y0, int y1)
+{
+	std::copy(&ovx[0][0] + y0*XCELLS, &ovx[0][0] + y1*XCELLS, &sim.vx[0][0] + y0*XCELLS);
+	std::copy(&ovy[0][0] + y0*XCELLS, &ovy[0][0] + y1*XCELLS, &sim.vy[0][0] + y0*XCELLS);
+	std::copy(&opv[0][0] + y0*XCELLS, &opv[0][0] + y1*XCELLS, &sim.pv[0][0] + y0*XCELLS);
+}
+
 void Air::Invert()
 {
 	auto &vx = sim.vx;
@@ -633,4 +727,50 @@ Air::Air(Simulation & simulation):
 	std::fill(&ohv   [0][0], &ohv   [0][0] + NCELL, 0.0f);
 	std::fill(&sim.pv[0][0], &sim.pv[0][0] + NCELL, 0.0f);
 	std::fill(&opv   [0][0], &opv   [0][0] + NCELL, 0.0f);
+
+	// One band per thread that can take part in running the graphs, which share their
+	// workers with every other graph in the process; fewer bands than that would leave
+	// threads idle, more would only add synchronisation.
+	auto bandCount = std::clamp(TaskGraph::Concurrency(), 1, YCELLS / 8);
+	airTasks = std::make_unique<TaskGraph>();
+	{
+		auto edges = airTasks->Add([this]() {
+			DampAirEdges();
+		});
+		auto bands = AddBandedPass(*airTasks, bandCount, { edges }, [this](int y0, int y1) {
+			ClearWallVelocities(y0, y1);
+		});
+		bands = AddBandedPass(*airTasks, bandCount, bands, [this](int y0, int y1) {
+			UpdateDensity(y0, y1);
+		});
+		bands = AddBandedPass(*airTasks, bandCount, bands, [this](int y0, int y1) {
+			UpdatePressure(y0, y1);
+		});
+		bands = AddBandedPass(*airTasks, bandCount, bands, [this](int y0, int y1) {
+			ApplyPressureGradient(y0, y1);
+		});
+		bands = AddBandedPass(*airTasks, bandCount, bands, [this](int y0, int y1) {
+			AdvectAir(y0, y1);
+		});
+		AddBandedPass(*airTasks, bandCount, bands, [this](int y0, int y1) {
+			CopyAir(y0, y1);
+		});
+	}
+	airhTasks = std::make_unique<TaskGraph>();
+	{
+		auto edges = airhTasks->Add([this]() {
+			ResetAirHEdges();
+		});
+		auto bands = AddBandedPass(*airhTasks, bandCount, { edges }, [this](int y0, int y1) {
+			ConvectAirH(y0, y1);
+		});
+		bands = AddBandedPass(*airhTasks, bandCount, bands, [this](int y0, int y1) {
+			AdvectAirH(y0, y1);
+		});
+		AddBandedPass(*airhTasks, bandCount, bands, [this](int y0, int y1) {
+			CopyAirH(y0, y1);
+		});
+	}
 }
+
+Air::~Air() = default;
@@ -1,8 +1,10 @@
 #pragma once
 #include "SimulationConfig.h"
+#include <memory>
 
 class Simulation;
 struct RenderableSimulation;
+class TaskGraph;
 
 class Air
 {
@@ -29,4 +31,29 @@ public:
 	void Invert();
 	void ApproximateBlockAirMaps();
 	Air(Simulation & sim);
+	~Air();
+
+private:
+	// update_air and update_airh are split into passes over row bands. Within a pass,
+	// a band only writes its own rows and only reads state that no band of the same
+	// pass writes, so the bands can run in any order or at the same time and give the
+	// same results as running them one after the other. Each pass waits for every
+	// band of the previous one. The graphs have no threads of their own, so an Air that
+	// never runs them in parallel, like those of the batch runner, costs no threads.
+	std::unique_ptr<TaskGraph> airTasks;
+	std::unique_ptr<TaskGraph> airhTasks;
+	void DampAirEdges();
+	void ClearWallVelocities(int y0, int y1);
+	void UpdateDensity(int y0, int y1);
+	void UpdatePressure(int y0, int y1);
+	void ApplyPressureGradient(int y0, int y1);
+	void AdvectAir(int y0, int y1);
+	void CopyAir(int y0, int y1);
+	void ResetAirHEdges();
+	// The serial update_airh updated velocities in place as it went. A cell's new velocity
+	// depends only on the cell itself, so they are all worked out first, and the heat
+	// advection reads the new ones wherever the serial update would have seen them.
+	void ConvectAirH(int y0, int y1);
+	void AdvectAirH(int y0, int y1);
+	void CopyAirH(int y0, int y1);
 };
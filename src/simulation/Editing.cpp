@@ -9,6 +9,7 @@
 #include "ElementClasses.h"
 #include "graphics/Renderer.h"
 #include "gui/game/Brush.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -47,9 +48,14 @@ void Simulation::Restore(const Snapshot &snap)
 	std::fill(elementCount, elementCount + PT_NUM, 0);
 	elementRecount = true;
 	force_stacking_check = true;
-	for (auto &part : parts.data)
+	// * Everything from parts.active onwards is already free, and everything the snapshot covers
+	//   gets overwritten below, so only the stretch between the two needs clearing. This keeps
+	//   Restore (and the RecalcFreeParticles call at the end) proportional to the number of
+	//   particles actually in use rather than to NPART.
+	auto snapActive = int(snap.Particles.size());
+	for (int i = snapActive; i < parts.active; ++i)
 	{
-		part.type = 0;
+		parts[i].type = 0;
 	}
 	std::copy(snap.AirPressure    .begin(), snap.AirPressure    .end(), &pv[0][0]        );
 	std::copy(snap.AirVelocityX   .begin(), snap.AirVelocityX   .end(), &vx[0][0]        );
@@ -116,7 +122,8 @@ void Simulation::Restore(const Snapshot &snap)
 	signs = snap.signs;
 	frameCount = snap.FrameCount;
 	rng.state(snap.RngState);
-	parts.active = NPART;
+	parts.active = std::max(parts.active, snapActive);
+	WakeAllBlocks();
 	RecalcFreeParticles(false);
 }
 
@@ -350,7 +357,6 @@ void Simulation::CreateWallBox(int x1, int y1, int x2, int y2, int wall)
 
 int Simulation::FloodWalls(int x, int y, int wall, int bm)
 {
-	int x1, x2, dy = CELL;
 	if (bm==-1)
 	{
 		if (wall==WL_ERASE || wall==WL_ERASEALL)
@@ -366,43 +372,19 @@ int Simulation::FloodWalls(int x, int y, int wall, int bm)
 	if (bmap[y/CELL][x/CELL]!=bm)
 		return 1;
 
-	// go left as far as possible
-	x1 = x2 = x;
-	while (x1>=CELL)
-	{
-		if (bmap[y/CELL][(x1-1)/CELL]!=bm)
-		{
-			break;
-		}
-		x1--;
-	}
-	while (x2<XRES-CELL)
-	{
-		if (bmap[y/CELL][(x2+1)/CELL]!=bm)
+	auto floodFill = floodFills.Begin();
+	auto matches = [this, bm](int x, int y) {
+		return bmap[y/CELL][x/CELL]==bm;
+	};
+	auto visit = [this, wall](int x1, int x2, int y) {
+		for (auto x = x1; x <= x2; x++)
 		{
-			break;
+			if (!CreateWalls(x, y, 0, 0, wall, nullptr))
+				return false;
 		}
-		x2++;
-	}
-
-	// fill span
-	for (x=x1; x<=x2; x++)
-	{
-		if (!CreateWalls(x, y, 0, 0, wall, nullptr))
-			return 0;
-	}
-	// fill children
-	if (y>=CELL)
-		for (x=x1; x<=x2; x++)
-			if (bmap[(y-dy)/CELL][x/CELL]==bm)
-				if (!FloodWalls(x, y-dy, wall, bm))
-					return 0;
-	if (y<YRES-CELL)
-		for (x=x1; x<=x2; x++)
-			if (bmap[(y+dy)/CELL][x/CELL]==bm)
-				if (!FloodWalls(x, y+dy, wall, bm))
-					return 0;
-	return 1;
+		return true;
+	};
+	return floodFill->Fill({ x, y }, RectBetween<int>({ CELL - 1, 0 }, { XRES - CELL, YRES - 1 }), CELL, matches, visit) ? 1 : 0;
 }
 
 int Simulation::CreatePartFlags(int p, int x, int y, int c, int flags)
@@ -723,70 +705,18 @@ bool Simulation::ColorCompare(const RendererFrame &frame, int x, int y, int repl
 
 void Simulation::ApplyDecorationFill(const RendererFrame &frame, int x, int y, int colR, int colG, int colB, int colA, int replaceR, int replaceG, int replaceB)
 {
-	int x1, x2;
-	char *bitmap = (char*)malloc(XRES*YRES); //Bitmap for checking
-	if (!bitmap)
+	if (!ColorCompare(frame, x, y, replaceR, replaceG, replaceB))
 		return;
-	memset(bitmap, 0, XRES*YRES);
-
-	if (!ColorCompare(frame, x, y, replaceR, replaceG, replaceB)) {
-		free(bitmap);
-		return;
-	}
-
-	try
-	{
-		CoordStack& cs = getCoordStackSingleton();
-		cs.clear();
-		
-		cs.push(x, y);
-		do
-		{
-			cs.pop(x, y);
-			x1 = x2 = x;
-			// go left as far as possible
-			while (x1>0)
-			{
-				if (bitmap[(x1-1)+y*XRES] || !ColorCompare(frame, x1-1, y, replaceR, replaceG, replaceB))
-				{
-					break;
-				}
-				x1--;
-			}
-			// go right as far as possible
-			while (x2<XRES-1)
-			{
-				if (bitmap[(x1+1)+y*XRES] || !ColorCompare(frame, x2+1, y, replaceR, replaceG, replaceB))
-				{
-					break;
-				}
-				x2++;
-			}
-			// fill span
-			for (x=x1; x<=x2; x++)
-			{
-				ApplyDecoration(x, y, colR, colG, colB, colA, DECO_DRAW);
-				bitmap[x+y*XRES] = 1;
-			}
-
-			if (y >= 1)
-				for (x=x1; x<=x2; x++)
-					if (!bitmap[x+(y-1)*XRES] && ColorCompare(frame, x, y-1, replaceR, replaceG, replaceB))
-						cs.push(x, y-1);
 
-			if (y < YRES-1)
-				for (x=x1; x<=x2; x++)
-					if (!bitmap[x+(y+1)*XRES] && ColorCompare(frame, x, y+1, replaceR, replaceG, replaceB))
-						cs.push(x, y+1);
-		} while (cs.getSize() > 0);
-	}
-	catch (std::exception& e)
-	{
-		std::cerr << e.what() << std::endl;
-		free(bitmap);
-		return;
-	}
-	free(bitmap);
+	// * What matches depends only on frame, so the spans can be decorated in any order, on any thread.
+	auto floodFill = floodFills.Begin();
+	floodFill->Collect({ x, y }, RES.OriginRect(), 1, [this, &frame, replaceR, replaceG, replaceB](int x, int y) {
+		return ColorCompare(frame, x, y, replaceR, replaceG, replaceB);
+	});
+	floodFill->VisitCollected([this, colR, colG, colB, colA](int x1, int x2, int y) {
+		for (auto x = x1; x <= x2; x++)
+			ApplyDecoration(x, y, colR, colG, colB, colA, DECO_DRAW);
+	});
 }
 
 int Simulation::CreateParts(int p, int positionX, int positionY, int c, Brush const &cBrush, int flags)
@@ -931,17 +861,9 @@ void Simulation::CreateBox(int p, int x1, int y1, int x2, int y2, int c, int fla
 int Simulation::FloodParts(int x, int y, int fullc, int cm, int flags)
 {
 	int c = TYP(fullc);
-	int x1, x2, dy = (c<PT_NUM)?1:CELL;
-	int coord_stack_limit = XRES*YRES;
-	unsigned short (*coord_stack)[2];
-	int coord_stack_size = 0;
+	int dy = (c<PT_NUM)?1:CELL;
 	int created_something = 0;
 
-	// Bitmap for checking where we've already looked
-	auto bitmapPtr = std::unique_ptr<char[]>(new char[XRES * YRES]);
-	char *bitmap = bitmapPtr.get();
-	std::fill(&bitmap[0], &bitmap[0] + XRES * YRES, 0);
-
 	if (cm==-1)
 	{
 		//if initial flood point is out of bounds, do nothing
@@ -975,39 +897,14 @@ int Simulation::FloodParts(int x, int y, int fullc, int cm, int flags)
 	if (!FloodFillPmapCheck(x, y, cm))
 		return 1;
 
-	coord_stack = (short unsigned int (*)[2])malloc(sizeof(unsigned short)*2*coord_stack_limit);
-	coord_stack[coord_stack_size][0] = x;
-	coord_stack[coord_stack_size][1] = y;
-	coord_stack_size++;
-
+	auto bounds = c ? RectBetween<int>({ CELL, CELL }, { XRES - CELL - 1, YRES - CELL - 1 }) : RES.OriginRect();
+	auto matches = [this, c, cm](int x, int y) {
+		return FloodFillPmapCheck(x, y, cm) && (c == 0 || !IsWallBlocking(x, y, c));
+	};
 	auto &sd = SimulationData::CRef();
 	auto &elements = sd.elements;
-	do
-	{
-		coord_stack_size--;
-		x = coord_stack[coord_stack_size][0];
-		y = coord_stack[coord_stack_size][1];
-		x1 = x2 = x;
-		// go left as far as possible
-		while (c?x1>CELL:x1>0)
-		{
-			if (bitmap[(y * XRES) + x1 - 1] || !FloodFillPmapCheck(x1-1, y, cm) || (c != 0 && IsWallBlocking(x1-1, y, c)))
-			{
-				break;
-			}
-			x1--;
-		}
-		// go right as far as possible
-		while (c?x2<XRES-CELL-1:x2<XRES-1)
-		{
-			if (bitmap[(y * XRES) + x2 + 1] || !FloodFillPmapCheck(x2+1, y, cm) || (c != 0 && IsWallBlocking(x2+1, y, c)))
-			{
-				break;
-			}
-			x2++;
-		}
-		// fill span
-		for (x=x1; x<=x2; x++)
+	auto visit = [this, fullc, cm, flags, &elements, &created_something](int x1, int x2, int y) {
+		for (auto x = x1; x <= x2; x++)
 		{
 			if (!fullc)
 			{
@@ -1027,37 +924,10 @@ int Simulation::FloodParts(int x, int y, int fullc, int cm, int flags)
 			}
 			else if (CreateParts(-2, x, y, 0, 0, fullc, flags))
 				created_something = 1;
-			bitmap[(y * XRES) + x] = 1;
 		}
-
-		if (c?y>=CELL+dy:y>=dy)
-			for (x=x1; x<=x2; x++)
-				if (!bitmap[((y - dy) * XRES) + x] && FloodFillPmapCheck(x, y-dy, cm) && (c == 0 || !IsWallBlocking(x, y-dy, c)))
-				{
-					coord_stack[coord_stack_size][0] = x;
-					coord_stack[coord_stack_size][1] = y-dy;
-					coord_stack_size++;
-					if (coord_stack_size>=coord_stack_limit)
-					{
-						free(coord_stack);
-						return -1;
-					}
-				}
-
-		if (c?y<YRES-CELL-dy:y<YRES-dy)
-			for (x=x1; x<=x2; x++)
-				if (!bitmap[((y + dy) * XRES) + x] && FloodFillPmapCheck(x, y+dy, cm) && (c == 0 || !IsWallBlocking(x, y+dy, c)))
-				{
-					coord_stack[coord_stack_size][0] = x;
-					coord_stack[coord_stack_size][1] = y+dy;
-					coord_stack_size++;
-					if (coord_stack_size>=coord_stack_limit)
-					{
-						free(coord_stack);
-						return -1;
-					}
-				}
-	} while (coord_stack_size>0);
-	free(coord_stack);
+		return true;
+	};
+	auto floodFill = floodFills.Begin();
+	floodFill->Fill({ x, y }, bounds, dy, matches, visit);
 	return created_something;
 }
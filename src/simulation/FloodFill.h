@@ -0,0 +1,254 @@
+#pragma once
+#include "SimulationConfig.h"
+#include "common/TaskGraph.h"
+#include "common/Vec2.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Scanline flood fill shared by the fill tools and the fills the simulation does on its
+// own. Positions visited since the last Begin are remembered in a plane of generation
+// stamps: a position counts as visited if its stamp equals the current generation, so
+// starting over is a matter of incrementing the generation rather than clearing the
+// plane, and the plane and seed stack are kept between fills. Works in particle
+// coordinates, or in any smaller coordinate system such as that of blocks.
+//
+// Not reentrant, nothing called back from a fill may start another one on the same object.
+// Get objects from a FloodFillStack where that may happen.
+class FloodFill
+{
+public:
+	struct Span
+	{
+		int x1, x2, y; // * Inclusive.
+	};
+
+private:
+	static constexpr size_t parallelThreshold = size_t(1) << 16; // * In pixels.
+
+	std::vector<uint32_t> visited;
+	uint32_t generation = 0;
+	std::vector<Vec2<int>> seeds;
+	std::vector<Span> spans;
+
+	template<class Matches>
+	void PushRuns(int x1, int x2, int y, Matches &matches)
+	{
+		auto inRun = false;
+		for (auto x = x1; x <= x2; ++x)
+		{
+			auto open = !Visited(x, y) && matches(x, y);
+			if (open && !inRun)
+			{
+				seeds.push_back({ x, y });
+			}
+			inRun = open;
+		}
+	}
+
+public:
+	FloodFill() : visited(XRES * YRES, 0)
+	{
+	}
+
+	// Starts a new set of fills, forgetting everything visited so far.
+	void Begin()
+	{
+		seeds.clear();
+		generation += 1;
+		if (!generation)
+		{
+			std::fill(visited.begin(), visited.end(), 0);
+			generation = 1;
+		}
+	}
+
+	bool Visited(int x, int y) const
+	{
+		return visited[y * XRES + x] == generation;
+	}
+
+	void MarkVisited(int x, int y)
+	{
+		visited[y * XRES + x] = generation;
+	}
+
+	// Seed stack for fills with rules that don't fit Fill, such as INST's wire crossings.
+	// It never overflows, unlike the fixed-size stack these fills used to share.
+	void Push(int x, int y)
+	{
+		seeds.push_back({ x, y });
+	}
+
+	bool Pop(int &x, int &y)
+	{
+		if (seeds.empty())
+		{
+			return false;
+		}
+		x = seeds.back().X;
+		y = seeds.back().Y;
+		seeds.pop_back();
+		return true;
+	}
+
+	// Fills the area connected to start of positions for which matches(x, y) is true
+	// and which haven't been visited yet, moving dy rows at a time vertically. Spans
+	// are extended and seeded only within bounds, though start itself may lie outside
+	// of it. visit(x1, x2, y) is called once for every span, after it is marked
+	// visited, and may change what matches returns for it. Stops as soon as visit
+	// returns false, and returns whether it did not.
+	template<class Matches, class Visit>
+	bool Fill(Vec2<int> start, Rect<int> bounds, int dy, Matches &&matches, Visit &&visit)
+	{
+		if (Visited(start.X, start.Y) || !matches(start.X, start.Y))
+		{
+			return true;
+		}
+		auto left = bounds.TopLeft().X;
+		auto right = bounds.BottomRight().X;
+		auto top = bounds.TopLeft().Y;
+		auto bottom = bounds.BottomRight().Y;
+		seeds.push_back(start);
+		while (!seeds.empty())
+		{
+			auto [ x, y ] = seeds.back();
+			seeds.pop_back();
+			// * Another span may have got to this seed after it was pushed, or visit may have changed it.
+			if (Visited(x, y) || !matches(x, y))
+			{
+				continue;
+			}
+			auto x1 = x;
+			auto x2 = x;
+			while (x1 > left && !Visited(x1 - 1, y) && matches(x1 - 1, y))
+			{
+				x1 -= 1;
+			}
+			while (x2 < right && !Visited(x2 + 1, y) && matches(x2 + 1, y))
+			{
+				x2 += 1;
+			}
+			std::fill(&visited[y * XRES + x1], &visited[y * XRES + x2] + 1, generation);
+			if (!visit(x1, x2, y))
+			{
+				seeds.clear();
+				return false;
+			}
+			if (y - dy >= top)
+			{
+				PushRuns(x1, x2, y - dy, matches);
+			}
+			if (y + dy <= bottom)
+			{
+				PushRuns(x1, x2, y + dy, matches);
+			}
+		}
+		return true;
+	}
+
+	// Like Fill, but only records the spans, for fills where what is done with them
+	// doesn't change what matches returns. Hand them to VisitCollected afterwards.
+	template<class Matches>
+	const std::vector<Span> &Collect(Vec2<int> start, Rect<int> bounds, int dy, Matches &&matches)
+	{
+		spans.clear();
+		Fill(start, bounds, dy, matches, [this](int x1, int x2, int y) {
+			spans.push_back({ x1, x2, y });
+			return true;
+		});
+		return spans;
+	}
+
+	// Calls visit(x1, x2, y) for every span found by the last Collect. Large fills are
+	// split between the workers of TaskGraph, so visit must only touch what is at the
+	// positions it is given, e.g. the particle at each of them.
+	template<class Visit>
+	void VisitCollected(Visit &&visit)
+	{
+		size_t pixels = 0;
+		for (auto &span : spans)
+		{
+			pixels += span.x2 - span.x1 + 1;
+		}
+		auto taskCount = std::min(size_t(TaskGraph::Concurrency()), pixels / parallelThreshold);
+		if (taskCount <= 1)
+		{
+			for (auto &span : spans)
+			{
+				visit(span.x1, span.x2, span.y);
+			}
+			return;
+		}
+		// * Split by pixels rather than spans, spans can be anything from one pixel to a whole row.
+		TaskGraph tasks;
+		size_t begin = 0;
+		size_t done = 0;
+		for (size_t t = 1; t <= taskCount; ++t)
+		{
+			auto end = begin;
+			while (end < spans.size() && done < pixels * t / taskCount)
+			{
+				done += spans[end].x2 - spans[end].x1 + 1;
+				end += 1;
+			}
+			tasks.Add([this, &visit, begin, end]() {
+				for (auto i = begin; i < end; ++i)
+				{
+					visit(spans[i].x1, spans[i].x2, spans[i].y);
+				}
+			});
+			begin = end;
+		}
+		tasks.Run(true);
+	}
+};
+
+// FloodFills for fills that may be started while another is in progress, such as a
+// particle fill that sparks INST, which floods the INST. Each fill gets an object of
+// its own for as long as the handle returned by Begin lives; handles must be released
+// in the reverse order they were taken in, which scoping them to a block ensures.
+class FloodFillStack
+{
+	std::vector<std::unique_ptr<FloodFill>> fills;
+	size_t depth = 0;
+
+public:
+	class Handle
+	{
+		FloodFillStack &stack;
+		FloodFill &fill;
+
+	public:
+		Handle(FloodFillStack &newStack, FloodFill &newFill) : stack(newStack), fill(newFill)
+		{
+		}
+
+		~Handle()
+		{
+			stack.depth -= 1;
+		}
+
+		Handle(const Handle &) = delete;
+		Handle &operator =(const Handle &) = delete;
+
+		FloodFill *operator ->()
+		{
+			return &fill;
+		}
+	};
+
+	// Like FloodFill::Begin, on an object no unfinished fill is using.
+	Handle Begin()
+	{
+		if (depth == fills.size())
+		{
+			fills.push_back(std::make_unique<FloodFill>());
+		}
+		auto &fill = *fills[depth];
+		depth += 1;
+		fill.Begin();
+		return Handle(*this, fill);
+	}
+};
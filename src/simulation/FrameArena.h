@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Bump allocator for temporaries that only live as long as a single operation, such as a
+// paste or a flood fill. Memory comes from blocks that are kept around between operations,
+// so once the arena has grown to what the largest operation needs, these operations stop
+// going to the heap. Nothing is freed on its own: a Scope hands back everything allocated
+// since it was opened when it goes away, so anything allocated from the arena must be gone
+// by then. Scopes nest, but not across threads; the arena belongs to the thread using the
+// Simulation that owns it.
+class FrameArena
+{
+	static constexpr size_t minBlockSize = size_t(1) << 20;
+
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> data;
+		size_t size;
+	};
+	std::vector<Block> blocks;
+	size_t currentBlock = 0;
+	size_t used = 0; // * In blocks[currentBlock].
+
+	void *AllocateSlow(size_t size, size_t alignment)
+	{
+		// * Blocks after the current one are left over from earlier operations, use the first one that's big enough.
+		for (currentBlock += 1; currentBlock < blocks.size(); ++currentBlock)
+		{
+			if (blocks[currentBlock].size >= size + alignment)
+			{
+				used = 0;
+				return Allocate(size, alignment);
+			}
+		}
+		auto blockSize = std::max({ minBlockSize, size + alignment, blocks.empty() ? size_t(0) : blocks.back().size * 2 });
+		blocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+		currentBlock = blocks.size() - 1;
+		used = 0;
+		return Allocate(size, alignment);
+	}
+
+public:
+	void *Allocate(size_t size, size_t alignment)
+	{
+		if (currentBlock < blocks.size())
+		{
+			auto &block = blocks[currentBlock];
+			auto base = reinterpret_cast<uintptr_t>(block.data.get());
+			auto begin = (base + used + alignment - 1) / alignment * alignment - base;
+			if (begin + size <= block.size)
+			{
+				used = begin + size;
+				return block.data.get() + begin;
+			}
+		}
+		return AllocateSlow(size, alignment);
+	}
+
+	template<class Item>
+	Item *Allocate(size_t count)
+	{
+		if (count > SIZE_MAX / sizeof(Item))
+		{
+			throw std::bad_alloc();
+		}
+		return static_cast<Item *>(Allocate(count * sizeof(Item), alignof(Item)));
+	}
+
+	class Scope
+	{
+		FrameArena &arena;
+		size_t block;
+		size_t used;
+
+	public:
+		Scope(FrameArena &newArena) : arena(newArena), block(newArena.currentBlock), used(newArena.used)
+		{
+		}
+
+		~Scope()
+		{
+			arena.currentBlock = block;
+			arena.used = used;
+		}
+
+		Scope(const Scope &) = delete;
+		Scope &operator =(const Scope &) = delete;
+	};
+
+	// Lets standard containers allocate from the arena. Deallocation does nothing, the
+	// memory is reclaimed when the enclosing Scope ends.
+	template<class Item>
+	struct Allocator
+	{
+		using value_type = Item;
+
+		FrameArena *arena;
+
+		Allocator(FrameArena &newArena) : arena(&newArena)
+		{
+		}
+
+		template<class Other>
+		Allocator(const Allocator<Other> &other) : arena(other.arena)
+		{
+		}
+
+		Item *allocate(size_t count)
+		{
+			return arena->Allocate<Item>(count);
+		}
+
+		void deallocate(Item *, size_t)
+		{
+		}
+
+		template<class Other>
+		bool operator ==(const Allocator<Other> &other) const
+		{
+			return arena == other.arena;
+		}
+	};
+
+	template<class Item>
+	using Vector = std::vector<Item, Allocator<Item>>;
+};
@@ -0,0 +1,126 @@
+#include "GOLBitboard.h"
+
+namespace
+{
+	using Row = GOLBitboard::Row;
+	constexpr auto words = GOLBitboard::words;
+	constexpr auto width = GOLBitboard::width;
+
+	constexpr uint64_t Bit(int b)
+	{
+		return uint64_t(1) << (b % 64);
+	}
+
+	// * Bits 1..width of a padded row, i.e. the ones that correspond to actual cells.
+	constexpr Row MakeValidMask()
+	{
+		Row mask{};
+		for (int b = 1; b <= width; ++b)
+		{
+			mask[b / 64] |= Bit(b);
+		}
+		return mask;
+	}
+	constexpr Row validMask = MakeValidMask();
+
+	// * Left neighbour of the cell at bit b ends up at bit b.
+	uint64_t ShiftLeftNeighbour(const Row &row, int w)
+	{
+		return (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+	}
+
+	// * Right neighbour of the cell at bit b ends up at bit b.
+	uint64_t ShiftRightNeighbour(const Row &row, int w)
+	{
+		return (row[w] >> 1) | (w < words - 1 ? row[w + 1] << 63 : 0);
+	}
+
+	// * Mask of cells whose bit-sliced neighbour count c3..c0 is one for which
+	//   bits (offset + count) of the ruleset are set.
+	uint64_t RuleMask(unsigned int ruleset, int offset, int minCount, uint64_t c0, uint64_t c1, uint64_t c2, uint64_t c3)
+	{
+		uint64_t mask = 0;
+		for (int n = minCount; n <= 8; ++n)
+		{
+			if ((ruleset >> (n + offset)) & 1)
+			{
+				mask |= (n & 1 ? c0 : ~c0) &
+				        (n & 2 ? c1 : ~c1) &
+				        (n & 4 ? c2 : ~c2) &
+				        (n & 8 ? c3 : ~c3);
+			}
+		}
+		return mask;
+	}
+}
+
+void GOLBitboard::Clear()
+{
+	for (auto &row : alive)
+	{
+		row.fill(0);
+	}
+}
+
+void GOLBitboard::Step(unsigned int ruleset)
+{
+	for (auto &row : alive)
+	{
+		row[0] &= ~Bit(0);
+		row[(width + 1) / 64] &= ~Bit(width + 1);
+		if (row[width / 64] & Bit(width))
+		{
+			row[0] |= Bit(0);
+		}
+		if (row[0] & Bit(1))
+		{
+			row[(width + 1) / 64] |= Bit(width + 1);
+		}
+	}
+	for (int y = 0; y < height; ++y)
+	{
+		auto &row = alive[y];
+		for (int w = 0; w < words; ++w)
+		{
+			auto l = ShiftLeftNeighbour(row, w);
+			auto c = row[w];
+			auto r = ShiftRightNeighbour(row, w);
+			sum0[y][w] = l ^ c ^ r;
+			sum1[y][w] = (l & c) | (r & (l ^ c));
+		}
+	}
+	for (int y = 0; y < height; ++y)
+	{
+		auto up = (y + height - 1) % height;
+		auto down = (y + 1) % height;
+		auto &row = alive[y];
+		for (int w = 0; w < words; ++w)
+		{
+			// * Rows above and below contribute three cells each, this row only two.
+			auto l = ShiftLeftNeighbour(row, w);
+			auto r = ShiftRightNeighbour(row, w);
+			auto m0 = l ^ r;
+			auto m1 = l & r;
+			auto u0 = sum0[up][w];
+			auto u1 = sum1[up][w];
+			auto d0 = sum0[down][w];
+			auto d1 = sum1[down][w];
+			// * Up + down, at most 6.
+			auto x0 = u0 ^ d0;
+			auto k0 = u0 & d0;
+			auto x1 = u1 ^ d1 ^ k0;
+			auto x2 = (u1 & d1) | (k0 & (u1 ^ d1));
+			// * Plus this row, at most 8.
+			auto c0 = x0 ^ m0;
+			auto k1 = x0 & m0;
+			auto c1 = x1 ^ m1 ^ k1;
+			auto k2 = (x1 & m1) | (k1 & (x1 ^ m1));
+			auto c2 = x2 ^ k2;
+			auto c3 = x2 & k2;
+			auto survive = RuleMask(ruleset, 0, 0, c0, c1, c2, c3);
+			// * Cells with no neighbours are never considered for birth.
+			auto birth = RuleMask(ruleset, 8, 1, c0, c1, c2, c3);
+			changes[y][w] = ((row[w] & ~survive) | (~row[w] & birth)) & validMask[w];
+		}
+	}
+}
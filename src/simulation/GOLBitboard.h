@@ -0,0 +1,53 @@
+#pragma once
+#include "SimulationConfig.h"
+#include <array>
+#include <cstdint>
+
+// Bit-parallel stepper for the common case of a single ruleset occupying the
+// whole GOL space. Cells are packed 64 to a word and neighbours are counted with
+// a bit-sliced adder tree, so a generation costs a few dozen word operations per
+// 64 cells instead of a walk over gol[][][]. Coordinates are relative to the GOL
+// space, i.e. the simulation area inset by one CELL on each side; wraparound
+// matches Simulation::SimulateGoL.
+class GOLBitboard
+{
+public:
+	static constexpr int width = XRES - 2 * CELL;
+	static constexpr int height = YRES - 2 * CELL;
+	// * One extra bit on each side of every row holds a copy of the cell on the
+	//   opposite edge, so horizontal wraparound falls out of plain shifts.
+	static constexpr int words = (width + 2 + 63) / 64;
+	using Row = std::array<uint64_t, words>;
+
+private:
+	std::array<Row, height> alive;
+	std::array<Row, height> sum0; // * Horizontal three-cell sum of each row, bit 0.
+	std::array<Row, height> sum1; // * Same, bit 1.
+	std::array<Row, height> changes;
+
+public:
+	void Clear();
+
+	void Set(int x, int y)
+	{
+		alive[y][(x + 1) / 64] |= uint64_t(1) << ((x + 1) % 64);
+	}
+
+	bool Get(int x, int y) const
+	{
+		return (alive[y][(x + 1) / 64] >> ((x + 1) % 64)) & 1;
+	}
+
+	// Computes the cells the ruleset (see SimulationData::builtinGol for the
+	// layout) wants to change: living ones that should start dying and empty ones
+	// that should be born. Whether a birth is actually possible (the pixel may be
+	// occupied by something else) is up to the caller.
+	void Step(unsigned int ruleset);
+
+	// Changed cells of row y, in the same padded layout as the internal rows;
+	// bit x + 1 corresponds to cell x.
+	const Row &Changes(int y) const
+	{
+		return changes[y];
+	}
+};
@@ -0,0 +1,61 @@
+#include "HeadlessSimulation.h"
+#include "Air.h"
+#include "Simulation.h"
+#include "client/GameSave.h"
+#include "common/platform/Platform.h"
+#include <iostream>
+
+// Seed for saves that carry no RNG state, in place of the time-based one RNG starts with.
+constexpr unsigned int headlessRngSeed = 0;
+
+std::unique_ptr<Simulation> LoadHeadlessSimulation(const ByteString &path)
+{
+	auto file = Platform::MapFile(path);
+	if (!file)
+	{
+		std::cerr << path << ": failed to read" << std::endl;
+		return nullptr;
+	}
+	std::unique_ptr<GameSave> save;
+	try
+	{
+		save = std::make_unique<GameSave>(file->Data(), false);
+	}
+	catch (const ParseException &e)
+	{
+		std::cerr << path << ": " << e.what() << std::endl;
+		return nullptr;
+	}
+	auto sim = std::make_unique<Simulation>();
+	sim->gravityMode = save->gravityMode;
+	sim->customGravityX = save->customGravityX;
+	sim->customGravityY = save->customGravityY;
+	sim->air->airMode = save->airMode;
+	sim->air->ambientAirTemp = save->ambientAirTemp;
+	sim->air->vorticityCoeff = save->vorticityCoeff;
+	sim->edgeMode = save->edgeMode;
+	sim->legacy_enable = save->legacyEnable;
+	sim->water_equal_test = save->waterEEnabled;
+	sim->aheat_enable = save->aheatEnable;
+	sim->EnableNewtonianGravity(save->gravityEnable);
+	sim->frameCount = save->frameCount;
+	if (save->hasRngState)
+	{
+		sim->rng.state(save->rngState);
+	}
+	else
+	{
+		sim->rng.seed(headlessRngSeed);
+	}
+	sim->ensureDeterminism = save->ensureDeterminism;
+	sim->clear_sim();
+	sim->Load(save.get(), true, { 0, 0 });
+	return sim;
+}
+
+void StepHeadlessSimulation(Simulation &sim)
+{
+	sim.BeforeSim(true);
+	sim.UpdateParticles(0, NPART);
+	sim.AfterSim();
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "common/String.h"
+#include <memory>
+
+class Simulation;
+
+// Helpers for the tools that run saves without the game around them, see PowderToyTrace
+// and PowderToyBatch.
+
+// Loads the save at path into a new simulation the way GameModel::SaveToSimParameters
+// would, minus the UI bits. Saves without RNG state get a fixed seed rather than one
+// taken from the clock, so that loading the same save always gives the same run.
+// Reports why to std::cerr and returns nullptr on failure.
+std::unique_ptr<Simulation> LoadHeadlessSimulation(const ByteString &path);
+
+// One whole frame, as GameModel::UpdateUpTo would do it with no Lua around.
+void StepHeadlessSimulation(Simulation &sim);
@@ -0,0 +1,100 @@
+#include "HeatGrid.h"
+#include <algorithm>
+
+namespace
+{
+	// * The stochastic path averages a particle with its 8 neighbours, so each neighbour
+	//   gets at most a ninth of the difference. This also keeps the explicit step stable:
+	//   a pixel never gives away more than 8/9 of its excess.
+	constexpr float neighbourWeight = 1.0f / 9.0f;
+}
+
+void HeatGrid::Clear()
+{
+	for (auto &row : capacity)
+	{
+		row.fill(0.0f);
+	}
+	for (auto &row : conduct)
+	{
+		row.fill(0.0f);
+	}
+	for (auto &row : heatClass)
+	{
+		row.fill(heatClassNone);
+	}
+}
+
+void HeatGrid::Step()
+{
+	// * Rows with nothing in them are common and cost nothing to skip.
+	std::array<bool, YRES> rowActive;
+	for (int y = 0; y < YRES; ++y)
+	{
+		rowActive[y] = std::any_of(capacity[y].begin(), capacity[y].end(), [](float c) {
+			return c > 0.0f;
+		});
+		if (rowActive[y])
+		{
+			flux[y].fill(0.0f);
+		}
+	}
+	// * Every pair of neighbours is visited once, through one of these offsets, and the
+	//   flux between them is added to one and subtracted from the other. Every loop over x
+	//   is free of dependencies between iterations so that it can be vectorised.
+	constexpr std::array<std::array<int, 2>, 4> offsets = {{
+		{ 0, 1 }, // * dy, dx
+		{ 1, -1 },
+		{ 1, 0 },
+		{ 1, 1 },
+	}};
+	std::array<float, XRES> pairFlux;
+	for (int y = 1; y < YRES - 1; ++y)
+	{
+		for (auto [ dy, dx ] : offsets)
+		{
+			if (!rowActive[y] || !rowActive[y + dy])
+			{
+				continue;
+			}
+			auto *ti = temp[y].data();
+			auto *ci = capacity[y].data();
+			auto *ki = conduct[y].data();
+			auto *hi = heatClass[y].data();
+			auto *tj = temp[y + dy].data() + dx;
+			auto *cj = capacity[y + dy].data() + dx;
+			auto *kj = conduct[y + dy].data() + dx;
+			auto *hj = heatClass[y + dy].data() + dx;
+			for (int x = 1; x < XRES - 1; ++x)
+			{
+				auto blocked = ((hi[x] & heatClassFilt) & (hj[x] >> 1)) | ((hj[x] & heatClassFilt) & (hi[x] >> 1));
+				auto g = std::min(ki[x], kj[x]) * std::min(ci[x], cj[x]) * float(1 - blocked);
+				pairFlux[x] = g * (tj[x] - ti[x]);
+			}
+			auto *fi = flux[y].data();
+			for (int x = 1; x < XRES - 1; ++x)
+			{
+				fi[x] += pairFlux[x];
+			}
+			auto *fj = flux[y + dy].data() + dx;
+			for (int x = 1; x < XRES - 1; ++x)
+			{
+				fj[x] -= pairFlux[x];
+			}
+		}
+	}
+	for (int y = 1; y < YRES - 1; ++y)
+	{
+		if (!rowActive[y])
+		{
+			continue;
+		}
+		auto *t = temp[y].data();
+		auto *c = capacity[y].data();
+		auto *f = flux[y].data();
+		for (int x = 1; x < XRES - 1; ++x)
+		{
+			t[x] = c[x] > 0.0f ? t[x] + neighbourWeight * f[x] / c[x] : t[x];
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "SimulationConfig.h"
+#include <array>
+#include <cstdint>
+
+// Deterministic alternative to the stochastic particle-particle conduction done in
+// Simulation::TransitionPhase. The simulation gathers the temperature, heat capacity
+// and conductance of the top particle of every pixel into dense grids, Step moves heat
+// between each pixel and its 8 neighbours in one explicit pass, and the simulation
+// scatters the temperatures back. The flux between two pixels is proportional to the
+// smaller of their conductances and heat capacities, so the total heat is conserved and
+// no pixel can overshoot its neighbours' temperatures.
+class HeatGrid
+{
+public:
+	enum HeatClass : uint8_t
+	{
+		heatClassNone    = 0,
+		heatClassFilt    = 1, // * FILT
+		heatClassFiltOff = 2, // * Particles that don't conduct to or from FILT, see TransitionPhase.
+	};
+
+	template<class Item>
+	using Grid = std::array<std::array<Item, XRES>, YRES>;
+
+	// Filled in by the simulation. capacity is 0 where there is nothing to conduct heat
+	// through, this must be the case for the outermost rows and columns. temp must be
+	// finite everywhere, value-initialise the grid to get that.
+	Grid<float> temp;
+	Grid<float> capacity;
+	Grid<float> conduct; // * 0 to 1, the chance per frame that the stochastic path conducts.
+	Grid<uint8_t> heatClass;
+
+private:
+	Grid<float> flux;
+
+public:
+	// Resets capacity, conduct and heatClass, temp is left alone.
+	void Clear();
+
+	// Replaces temp with the temperatures one frame later.
+	void Step();
+};
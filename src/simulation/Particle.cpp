@@ -1,6 +1,7 @@
 #include "Particle.h"
 #include <cstddef>
 #include <cassert>
+#include <map>
 
 std::vector<StructProperty> const &Particle::GetProperties()
 {
@@ -34,6 +35,36 @@ std::vector<StructPropertyAlias> const &Particle::GetPropertyAliases()
 	return aliases;
 }
 
+std::optional<unsigned int> Particle::GetPropertyIndex(const ByteString &name)
+{
+	struct DoOnce
+	{
+		std::map<ByteString, unsigned int> indices;
+
+		DoOnce()
+		{
+			auto &properties = GetProperties();
+			for (unsigned int i = 0; i < properties.size(); ++i)
+			{
+				indices.insert({ properties[i].Name, i });
+			}
+			for (auto &alias : GetPropertyAliases())
+			{
+				auto it = indices.find(alias.to);
+				assert(it != indices.end());
+				indices.insert({ alias.from, it->second });
+			}
+		}
+	};
+	static DoOnce doOnce;
+	auto it = doOnce.indices.find(name);
+	if (it == doOnce.indices.end())
+	{
+		return std::nullopt;
+	}
+	return it->second;
+}
+
 std::vector<unsigned int> const &Particle::PossiblyCarriesType()
 {
 	struct DoOnce
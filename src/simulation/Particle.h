@@ -1,5 +1,6 @@
 #pragma once
 #include "StructProperty.h"
+#include <optional>
 #include <vector>
 
 struct Particle
@@ -38,6 +39,9 @@ struct Particle
 	 by higher-level processes referring to them by name such as Lua or the property tool **/
 	static std::vector<StructProperty> const &GetProperties();
 	static std::vector<StructPropertyAlias> const &GetPropertyAliases();
+	/** Resolves a property name or alias to its index in GetProperties() with a single lookup;
+	 callers on hot paths should resolve once and keep the index **/
+	static std::optional<unsigned int> GetPropertyIndex(const ByteString &name);
 	static std::vector<unsigned int> const &PossiblyCarriesType();
 };
 
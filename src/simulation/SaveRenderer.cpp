@@ -8,6 +8,9 @@
 #include "Simulation.h"
 #include "SimulationData.h"
 
+// * Thumbnails at most this fraction of the size of the save skip effects.
+constexpr auto thumbnailShrink = 2;
+
 SaveRenderer::SaveRenderer()
 {
 	sim = std::make_unique<Simulation>();
@@ -43,3 +46,27 @@ std::unique_ptr<VideoBuffer> SaveRenderer::Render(const GameSave *save, bool fir
 
 	return tempThumb;
 }
+
+std::unique_ptr<VideoBuffer> SaveRenderer::Render(const GameSave *save, bool fire, RendererSettings rendererSettings, Vec2<int> bound)
+{
+	auto saveSize = save->blockSize * CELL;
+	auto size = VideoBuffer::SizeToFit(saveSize, bound);
+	if (size.X * thumbnailShrink > saveSize.X || size.Y * thumbnailShrink > saveSize.Y)
+	{
+		auto thumb = Render(save, fire, rendererSettings);
+		thumb->Resize(size, true);
+		return thumb;
+	}
+
+	auto &sd = SimulationData::CRef();
+	std::shared_lock lk(sd.elementGraphicsMx);
+	std::lock_guard<std::mutex> gx(renderMutex);
+
+	ren->ApplySettings(rendererSettings);
+
+	sim->clear_sim();
+
+	sim->Load(save, true, { 0, 0 });
+	ren->ClearAccumulation();
+	return ren->RenderThumbnail(saveSize.OriginRect(), size);
+}
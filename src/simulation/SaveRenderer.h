@@ -6,6 +6,7 @@
 #include "common/ExplicitSingleton.h"
 #include "graphics/RendererSettings.h"
 #include "common/String.h"
+#include "common/Vec2.h"
 
 class GameSave;
 class VideoBuffer;
@@ -22,4 +23,7 @@ public:
 	SaveRenderer();
 	~SaveRenderer();
 	std::unique_ptr<VideoBuffer> Render(const GameSave *save, bool fire, RendererSettings rendererSettings);
+	// Same as the above followed by VideoBuffer::ResizeToFit, but goes through Renderer::RenderThumbnail,
+	// ignoring fire, if that makes the image a lot smaller than the save.
+	std::unique_ptr<VideoBuffer> Render(const GameSave *save, bool fire, RendererSettings rendererSettings, Vec2<int> bound);
 };
@@ -0,0 +1,79 @@
+#pragma once
+#include "Simulation.h"
+#include <algorithm>
+#include <array>
+
+// Visits the particles that DTEC, LSNS, TSNS and VSNS look at: those in the square of
+// radius rd around (x, y), minus (x, y) itself, taking pmap over photons where both are
+// set. The order is that of the scans these sensors used to do, columns left to right and
+// each top to bottom, or the exact opposite if backwards is set, so a sensor that only
+// cares about the last match can stop at the first one. Stops as soon as visit returns
+// true, and returns whether it did.
+//
+// Blocks that pmapOccupied and photonsOccupied say are empty are skipped. These are kept
+// up to date while particles update, so skipping them gives the same results as visiting
+// every position.
+template<bool backwards, class Visit>
+bool ScanSensorRange(const Simulation &sim, int x, int y, int rd, Visit &&visit)
+{
+	auto x0 = std::max(x - rd, 0);
+	auto y0 = std::max(y - rd, 0);
+	auto x1 = std::min(x + rd, XRES - 1);
+	auto y1 = std::min(y + rd, YRES - 1);
+	if (x0 > x1 || y0 > y1)
+	{
+		return false;
+	}
+	auto bx0 = x0 / CELL;
+	auto bx1 = x1 / CELL;
+	auto by0 = y0 / CELL;
+	auto by1 = y1 / CELL;
+	std::array<int, YCELLS> occupiedRows; // * Block rows of the current block column in visiting order.
+	for (auto bxi = 0; bxi <= bx1 - bx0; ++bxi)
+	{
+		auto bx = backwards ? bx1 - bxi : bx0 + bxi;
+		auto occupiedCount = 0;
+		for (auto byi = 0; byi <= by1 - by0; ++byi)
+		{
+			auto by = backwards ? by1 - byi : by0 + byi;
+			if (sim.pmapOccupied[by][bx] || sim.photonsOccupied[by][bx])
+			{
+				occupiedRows[occupiedCount++] = by;
+			}
+		}
+		if (!occupiedCount)
+		{
+			continue;
+		}
+		auto cx0 = std::max(x0, bx * CELL);
+		auto cx1 = std::min(x1, bx * CELL + CELL - 1);
+		for (auto cxi = 0; cxi <= cx1 - cx0; ++cxi)
+		{
+			auto cx = backwards ? cx1 - cxi : cx0 + cxi;
+			for (auto k = 0; k < occupiedCount; ++k)
+			{
+				auto by = occupiedRows[k];
+				auto cy0 = std::max(y0, by * CELL);
+				auto cy1 = std::min(y1, by * CELL + CELL - 1);
+				for (auto cyi = 0; cyi <= cy1 - cy0; ++cyi)
+				{
+					auto cy = backwards ? cy1 - cyi : cy0 + cyi;
+					if (cx == x && cy == y)
+					{
+						continue;
+					}
+					auto r = sim.pmap[cy][cx];
+					if (!r)
+					{
+						r = sim.photons[cy][cx];
+					}
+					if (r && visit(r))
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return false;
+}
@@ -14,6 +14,7 @@ void SimTool::CallPerform(Simulation *sim, ui::Point position, ui::Point brushOf
 	{
 		// TODO: maybe do something with the result
 		Perform(this, sim, cpart, position.X, position.Y, brushOffset.X, brushOffset.Y, Strength);
+		sim->WakeBlock(position.X, position.Y);
 	}
 }
 
@@ -1,5 +1,7 @@
 #include "Simulation.h"
 #include "Air.h"
+#include "GOLBitboard.h"
+#include "HeatGrid.h"
 #include "ElementClasses.h"
 #include "TransitionConstants.h"
 #include "gravity/Gravity.h"
@@ -9,6 +11,7 @@
 #include "common/tpt-compat.h"
 #include "common/tpt-rand.h"
 #include "common/Defer.h"
+#include "common/TaskGraph.h"
 #include "gui/game/Brush.h"
 #include "elements/EMP.h"
 #include "elements/LOLZ.h"
@@ -16,9 +19,10 @@
 #include "elements/PIPE.h"
 #include "elements/FILT.h"
 #include "elements/PRTI.h"
+#include <algorithm>
+#include <bit>
 #include <iostream>
 #include <set>
-#include <stack>
 
 static float remainder_p(float x, float y)
 {
@@ -34,12 +38,13 @@ void Simulation::Load(const GameSave *save, bool includePressure, Vec2<int> bloc
 
 	RecalcFreeParticles(false);
 
+	FrameArena::Scope arenaScope(arena);
 	struct ExistingParticle
 	{
 		int id;
 		Vec2<int> pos;
 	};
-	std::vector<ExistingParticle> existingParticles;
+	FrameArena::Vector<ExistingParticle> existingParticles(arena);
 	auto pasteArea = RES.OriginRect() & RectSized(partP, save->blockSize * CELL);
 	for (int i = 0; i < parts.active; i++)
 	{
@@ -55,7 +60,7 @@ void Simulation::Load(const GameSave *save, bool includePressure, Vec2<int> bloc
 	std::sort(existingParticles.begin(), existingParticles.end(), [](const auto &lhs, const auto &rhs) {
 		return std::tie(lhs.pos.Y, lhs.pos.X) < std::tie(rhs.pos.Y, rhs.pos.X);
 	});
-	PlaneAdapter<std::vector<size_t>> existingParticleIndices(pasteArea.size, existingParticles.size());
+	PlaneAdapter<FrameArena::Vector<size_t>> existingParticleIndices(pasteArea.size, existingParticles.size(), arena);
 	{
 		auto lastPos = Vec2<int>{ -1, -1 }; // not a valid pos in existingParticles
 		for (auto it = existingParticles.begin(); it != existingParticles.end(); ++it)
@@ -85,7 +90,8 @@ void Simulation::Load(const GameSave *save, bool includePressure, Vec2<int> bloc
 	Defer restorePrettyPowders([this, oldPrettyPowders]() {
 		pretty_powder = oldPrettyPowders;
 	});
-	std::map<unsigned int, unsigned int> soapList;
+	using SoapList = std::map<unsigned int, unsigned int, std::less<unsigned int>, FrameArena::Allocator<std::pair<const unsigned int, unsigned int>>>;
+	SoapList soapList(arena);
 	for (int n = 0; n < NPART && n < save->particlesCount; n++)
 	{
 		Particle tempPart = save->particles[n];
@@ -226,18 +232,19 @@ void Simulation::Load(const GameSave *save, bool includePressure, Vec2<int> bloc
 	parts.active = NPART;
 	force_stacking_check = true;
 	Element_PPIP_ppip_changed = 1;
+	WakeAllBlocks();
 
 	// Sort out pmap, just to be on the safe side.
 	RecalcFreeParticles(false);
 
 	// fix SOAP links using soapList, a map of old particle ID -> new particle ID
 	// loop through every old particle (loaded from save), and convert .tmp / .tmp2
-	for (std::map<unsigned int, unsigned int>::iterator iter = soapList.begin(), end = soapList.end(); iter != end; ++iter)
+	for (SoapList::iterator iter = soapList.begin(), end = soapList.end(); iter != end; ++iter)
 	{
 		int i = (*iter).second;
 		if ((parts[i].ctype & 0x2) == 2)
 		{
-			std::map<unsigned int, unsigned int>::iterator n = soapList.find(parts[i].tmp);
+			SoapList::iterator n = soapList.find(parts[i].tmp);
 			if (n != end)
 				parts[i].tmp = n->second;
 			// sometimes the proper SOAP isn't found. It should remove the link, but seems to break some saves
@@ -245,7 +252,7 @@ void Simulation::Load(const GameSave *save, bool includePressure, Vec2<int> bloc
 		}
 		if ((parts[i].ctype & 0x4) == 4)
 		{
-			std::map<unsigned int, unsigned int>::iterator n = soapList.find(parts[i].tmp2);
+			SoapList::iterator n = soapList.find(parts[i].tmp2);
 			if (n != end)
 				parts[i].tmp2 = n->second;
 			// sometimes the proper SOAP isn't found. It should remove the link, but seems to break some saves
@@ -484,77 +491,42 @@ bool Simulation::FloodFillPmapCheck(int x, int y, int type) const
 		return TYP(pmap[y][x]) == type;
 }
 
-CoordStack& Simulation::getCoordStackSingleton()
-{
-	// Future-proofing in case Simulation is later multithreaded
-	thread_local CoordStack cs;
-	return cs;
-}
-
 int Simulation::flood_prop(int x, int y, const AccessProperty &changeProperty)
 {
-	int i, x1, x2, dy = 1;
-	int did_something = 0;
 	int r = pmap[y][x];
 	if (!r)
 		r = photons[y][x];
 	if (!r)
 		return 0;
 	int parttype = TYP(r);
-	char * bitmap = (char*)malloc(XRES*YRES); //Bitmap for checking
-	if (!bitmap) return -1;
-	memset(bitmap, 0, XRES*YRES);
-	try
-	{
-		CoordStack& cs = getCoordStackSingleton();
-		cs.clear();
-
-		cs.push(x, y);
-		do
+	auto bounds = RectBetween<int>({ CELL - 1, CELL }, { XRES - CELL, YRES - CELL - 1 });
+	auto matches = [this, parttype](int x, int y) {
+		return FloodFillPmapCheck(x, y, parttype);
+	};
+	auto visit = [this, &changeProperty](int x1, int x2, int y) {
+		for (auto x = x1; x <= x2; x++)
 		{
-			cs.pop(x, y);
-			x1 = x2 = x;
-			while (x1>=CELL)
-			{
-				if (!FloodFillPmapCheck(x1-1, y, parttype) || bitmap[(y*XRES)+x1-1])
-					break;
-				x1--;
-			}
-			while (x2<XRES-CELL)
-			{
-				if (!FloodFillPmapCheck(x2+1, y, parttype) || bitmap[(y*XRES)+x2+1])
-					break;
-				x2++;
-			}
-			for (x=x1; x<=x2; x++)
-			{
-				i = pmap[y][x];
-				if (!i)
-					i = photons[y][x];
-				if (!i)
-					continue;
-				changeProperty.Set(this, ID(i));
-				bitmap[(y*XRES)+x] = 1;
-				did_something = 1;
-			}
-			if (y>=CELL+dy)
-				for (x=x1; x<=x2; x++)
-					if (FloodFillPmapCheck(x, y-dy, parttype) && !bitmap[((y-dy)*XRES)+x])
-						cs.push(x, y-dy);
-			if (y<YRES-CELL-dy)
-				for (x=x1; x<=x2; x++)
-					if (FloodFillPmapCheck(x, y+dy, parttype) && !bitmap[((y+dy)*XRES)+x])
-						cs.push(x, y+dy);
-		} while (cs.getSize()>0);
-	}
-	catch (std::exception& e)
-	{
-		std::cerr << e.what() << std::endl;
-		free(bitmap);
-		return -1;
+			auto i = pmap[y][x];
+			if (!i)
+				i = photons[y][x];
+			if (!i)
+				continue;
+			changeProperty.Set(this, ID(i));
+		}
+		return true;
+	};
+	auto floodFill = floodFills.Begin();
+	if (changeProperty.propertyIndex == FIELD_TYPE)
+	{
+		// * Changing the type changes what matches, and part_change_type is not safe to run on several threads.
+		floodFill->Fill({ x, y }, bounds, 1, matches, visit);
 	}
-	free(bitmap);
-	return did_something;
+	else
+	{
+		floodFill->Collect({ x, y }, bounds, 1, matches);
+		floodFill->VisitCollected(visit);
+	}
+	return 1;
 }
 
 int Simulation::FloodINST(int x, int y)
@@ -573,92 +545,81 @@ int Simulation::FloodINST(int x, int y)
 	if (!isSparkableInst(x,y))
 		return 1;
 
-	CoordStack& cs = getCoordStackSingleton();
-	cs.clear();
-
-	cs.push(x, y);
-
-	try
+	// * Sparked INST stops being sparkable, which is all the bookkeeping this fill needs, so only the seed stack is used.
+	auto floodFill = floodFills.Begin();
+	floodFill->Push(x, y);
+	while (floodFill->Pop(x, y))
 	{
-		do
+		x1 = x2 = x;
+		// go left as far as possible
+		while (x1>=CELL && isSparkableInst(x1-1, y))
 		{
-			cs.pop(x, y);
-			x1 = x2 = x;
-			// go left as far as possible
-			while (x1>=CELL && isSparkableInst(x1-1, y))
-			{
-				x1--;
-			}
-			// go right as far as possible
-			while (x2<XRES-CELL && isSparkableInst(x2+1, y))
-			{
-				x2++;
-			}
-			// fill span
-			for (x=x1; x<=x2; x++)
-			{
-				if (create_part(-1, x, y, PT_SPRK)>=0)
-					created_something = 1;
-			}
+			x1--;
+		}
+		// go right as far as possible
+		while (x2<XRES-CELL && isSparkableInst(x2+1, y))
+		{
+			x2++;
+		}
+		// fill span
+		for (x=x1; x<=x2; x++)
+		{
+			if (create_part(-1, x, y, PT_SPRK)>=0)
+				created_something = 1;
+		}
 
-			// add vertically adjacent pixels to stack
-			// (wire crossing for INST)
-			if (y>=CELL+1 && x1==x2 &&
-				isInst(x1-1, y-1) && isInst(x1, y-1) && isInst(x1+1, y-1) &&
-				!isInst(x1-1, y-2) && isInst(x1, y-2) && !isInst(x1+1, y-2))
+		// add vertically adjacent pixels to stack
+		// (wire crossing for INST)
+		if (y>=CELL+1 && x1==x2 &&
+			isInst(x1-1, y-1) && isInst(x1, y-1) && isInst(x1+1, y-1) &&
+			!isInst(x1-1, y-2) && isInst(x1, y-2) && !isInst(x1+1, y-2))
+		{
+			// travelling vertically up, skipping a horizontal line
+			if (isSparkableInst(x1, y-2))
 			{
-				// travelling vertically up, skipping a horizontal line
-				if (isSparkableInst(x1, y-2))
-				{
-						cs.push(x1, y-2);
-				}
+					floodFill->Push(x1, y-2);
 			}
-			else if (y>=CELL+1)
+		}
+		else if (y>=CELL+1)
+		{
+			for (x=x1; x<=x2; x++)
 			{
-				for (x=x1; x<=x2; x++)
+				if (isSparkableInst(x, y-1))
 				{
-					if (isSparkableInst(x, y-1))
+					if (x==x1 || x==x2 || y>=YRES-CELL-1 || !isInst(x, y+1) || isInst(x+1, y+1) || isInst(x-1, y+1))
 					{
-						if (x==x1 || x==x2 || y>=YRES-CELL-1 || !isInst(x, y+1) || isInst(x+1, y+1) || isInst(x-1, y+1))
-						{
-							// if at the end of a horizontal section, or if it's a T junction or not a 1px wire crossing
-							cs.push(x, y-1);
-						}
+						// if at the end of a horizontal section, or if it's a T junction or not a 1px wire crossing
+						floodFill->Push(x, y-1);
 					}
 				}
 			}
+		}
 
-			if (y<YRES-CELL-1 && x1==x2 &&
-				isInst(x1-1, y+1) && isInst(x1, y+1) && isInst(x1+1, y+1) &&
-				!isInst(x1-1, y+2) && isInst(x1, y+2) && !isInst(x1+1, y+2))
+		if (y<YRES-CELL-1 && x1==x2 &&
+			isInst(x1-1, y+1) && isInst(x1, y+1) && isInst(x1+1, y+1) &&
+			!isInst(x1-1, y+2) && isInst(x1, y+2) && !isInst(x1+1, y+2))
+		{
+			// travelling vertically down, skipping a horizontal line
+			if (isSparkableInst(x1, y+2))
 			{
-				// travelling vertically down, skipping a horizontal line
-				if (isSparkableInst(x1, y+2))
-				{
-					cs.push(x1, y+2);
-				}
+				floodFill->Push(x1, y+2);
 			}
-			else if (y<YRES-CELL-1)
+		}
+		else if (y<YRES-CELL-1)
+		{
+			for (x=x1; x<=x2; x++)
 			{
-				for (x=x1; x<=x2; x++)
+				if (isSparkableInst(x, y+1))
 				{
-					if (isSparkableInst(x, y+1))
+					if (x==x1 || x==x2 || y<0 || !isInst(x, y-1) || isInst(x+1, y-1) || isInst(x-1, y-1))
 					{
-						if (x==x1 || x==x2 || y<0 || !isInst(x, y-1) || isInst(x+1, y-1) || isInst(x-1, y-1))
-						{
-							// if at the end of a horizontal section, or if it's a T junction or not a 1px wire crossing
-							cs.push(x, y+1);
-						}
-
+						// if at the end of a horizontal section, or if it's a T junction or not a 1px wire crossing
+						floodFill->Push(x, y+1);
 					}
+
 				}
 			}
-		} while (cs.getSize()>0);
-	}
-	catch (std::exception& e)
-	{
-		std::cerr << e.what() << std::endl;
-		return -1;
+		}
 	}
 
 	return created_something;
@@ -671,67 +632,53 @@ bool Simulation::flood_water(int x, int y, int i)
 	if (!r)
 		return false;
 
-	// Bitmap for checking where we've already looked
-	auto bitmapPtr = std::unique_ptr<char[]>(new char[XRES * YRES]);
-	char *bitmap = bitmapPtr.get();
-	std::fill(&bitmap[0], &bitmap[0] + XRES * YRES, 0);
-
+	// * Not Fill: the span search below doesn't stop at visited positions on the right, and
+	// * changing that would change how water settles in existing saves.
+	auto floodFill = floodFills.Begin();
 	auto &sd = SimulationData::CRef();
 	auto &elements = sd.elements;
-	try
+	floodFill->Push(x, y);
+	while (floodFill->Pop(x, y))
 	{
-		CoordStack& cs = getCoordStackSingleton();
-		cs.clear();
-
-		cs.push(x, y);
-		do
+		x1 = x2 = x;
+		while (x1 >= CELL)
 		{
-			cs.pop(x, y);
-			x1 = x2 = x;
-			while (x1 >= CELL)
-			{
-				if (elements[TYP(pmap[y][x1 - 1])].Falldown != 2 || bitmap[(y * XRES) + x1 - 1])
-					break;
-				x1--;
-			}
-			while (x2 < XRES-CELL)
-			{
-				if (elements[TYP(pmap[y][x2 + 1])].Falldown != 2 || bitmap[(y * XRES) + x1 - 1])
-					break;
-				x2++;
-			}
-			for (int x = x1; x <= x2; x++)
+			if (elements[TYP(pmap[y][x1 - 1])].Falldown != 2 || floodFill->Visited(x1 - 1, y))
+				break;
+			x1--;
+		}
+		while (x2 < XRES-CELL)
+		{
+			if (elements[TYP(pmap[y][x2 + 1])].Falldown != 2 || floodFill->Visited(x1 - 1, y))
+				break;
+			x2++;
+		}
+		for (int x = x1; x <= x2; x++)
+		{
+			if ((y - 1) > originalY && !pmap[y - 1][x])
 			{
-				if ((y - 1) > originalY && !pmap[y - 1][x])
-				{
-					// Try to move the water to a random position on this line, because there's probably a free location somewhere
-					int randPos = rng.between(x, x2);
-					if (!pmap[y - 1][randPos] && eval_move(parts[i].type, randPos, y - 1, nullptr))
-						x = randPos;
-					// Couldn't move to random position, so try the original position on the left
-					else if (!eval_move(parts[i].type, x, y - 1, nullptr))
-						continue;
-
-					move(i, originalX, originalY, float(x), float(y - 1));
-					return true;
-				}
+				// Try to move the water to a random position on this line, because there's probably a free location somewhere
+				int randPos = rng.between(x, x2);
+				if (!pmap[y - 1][randPos] && eval_move(parts[i].type, randPos, y - 1, nullptr))
+					x = randPos;
+				// Couldn't move to random position, so try the original position on the left
+				else if (!eval_move(parts[i].type, x, y - 1, nullptr))
+					continue;
 
-				bitmap[(y * XRES) + x] = 1;
+				move(i, originalX, originalY, float(x), float(y - 1));
+				return true;
 			}
-			if (y >= CELL + 1)
-				for (int x = x1; x <= x2; x++)
-					if (elements[TYP(pmap[y - 1][x])].Falldown == 2 && !bitmap[((y - 1) * XRES) + x])
-						cs.push(x, y - 1);
-			if (y < YRES - CELL - 1)
-				for (int x = x1; x <= x2; x++)
-					if (elements[TYP(pmap[y + 1][x])].Falldown == 2 && !bitmap[((y + 1) * XRES) + x])
-						cs.push(x, y + 1);
-		} while (cs.getSize() > 0);
-	}
-	catch (std::exception &e)
-	{
-		std::cerr << e.what() << std::endl;
-		return false;
+
+			floodFill->MarkVisited(x, y);
+		}
+		if (y >= CELL + 1)
+			for (int x = x1; x <= x2; x++)
+				if (elements[TYP(pmap[y - 1][x])].Falldown == 2 && !floodFill->Visited(x, y - 1))
+					floodFill->Push(x, y - 1);
+		if (y < YRES - CELL - 1)
+			for (int x = x1; x <= x2; x++)
+				if (elements[TYP(pmap[y + 1][x])].Falldown == 2 && !floodFill->Visited(x, y + 1))
+					floodFill->Push(x, y + 1);
 	}
 	return false;
 }
@@ -1008,9 +955,17 @@ void Simulation::clear_sim(void)
 	parts.Reset();
 	NUM_PARTS = 0;
 	memset(pmap, 0, sizeof(pmap));
+	memset(pmapOccupied, 0, sizeof(pmapOccupied));
+	memset(blockActive, 0, sizeof(blockActive));
+	memset(sleepBmap, 0, sizeof(sleepBmap));
+	memset(sleepEmap, 0, sizeof(sleepEmap));
+	memset(sleepPv, 0, sizeof(sleepPv));
+	memset(sleepHv, 0, sizeof(sleepHv));
+	WakeAllBlocks();
 	memset(fvx, 0, sizeof(fvx));
 	memset(fvy, 0, sizeof(fvy));
 	memset(photons, 0, sizeof(photons));
+	memset(photonsOccupied, 0, sizeof(photonsOccupied));
 	memset(wireless, 0, sizeof(wireless));
 	memset(gol, 0, sizeof(gol));
 	memset(portalp, 0, sizeof(portalp));
@@ -1095,7 +1050,7 @@ int Simulation::eval_move(int pt, int nx, int ny, unsigned *rr) const
 		return 0;
 	auto &sd = SimulationData::CRef();
 	auto &can_move = sd.can_move;
-	auto &elements = sd.elements;
+	auto &hot = sd.hotElements;
 	result = can_move[pt][TYP(r)];
 	if (result == 3)
 	{
@@ -1158,7 +1113,7 @@ int Simulation::eval_move(int pt, int nx, int ny, unsigned *rr) const
 	{
 		if (IsWallBlocking(nx, ny, pt))
 			return 0;
-		if (bmap[ny/CELL][nx/CELL]==WL_EHOLE && !emap[ny/CELL][nx/CELL] && !(elements[pt].Properties&TYPE_SOLID) && !(elements[TYP(r)].Properties&TYPE_SOLID))
+		if (bmap[ny/CELL][nx/CELL]==WL_EHOLE && !emap[ny/CELL][nx/CELL] && !(hot[pt].Properties&TYPE_SOLID) && !(hot[TYP(r)].Properties&TYPE_SOLID))
 			return 2;
 	}
 	return result;
@@ -1446,6 +1401,7 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 			if (s)
 			{
 				pmap[ny][nx] = (s&~PMAPMASK)|parts[ID(s)].type;
+				MarkPmap(nx, ny);
 				parts[ID(s)].x = float(nx);
 				parts[ID(s)].y = float(ny);
 			}
@@ -1454,6 +1410,7 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 			parts[ri].x = float(x);
 			parts[ri].y = float(y);
 			pmap[y][x] = PMAP(ri, parts[ri].type);
+			MarkPmap(x, y);
 			return 1;
 		}
 
@@ -1464,6 +1421,7 @@ int Simulation::try_move(int i, int x, int y, int nx, int ny)
 		int rx = int(parts[ri].x + 0.5f);
 		int ry = int(parts[ri].y + 0.5f);
 		pmap[ry][rx] = PMAP(ri, parts[ri].type);
+		MarkPmap(rx, ry);
 	}
 	return 1;
 }
@@ -1522,10 +1480,18 @@ bool Simulation::move(int i, int x, int y, float nxf, float nyf)
 			kill_part(i);
 			return false;
 		}
+		WakeBlock(x, y);
+		WakeBlock(nx, ny);
 		if (elements[t].Properties & TYPE_ENERGY)
+		{
 			photons[ny][nx] = PMAP(i, t);
+			MarkPhotons(nx, ny);
+		}
 		else if (t)
+		{
 			pmap[ny][nx] = PMAP(i, t);
+			MarkPmap(nx, ny);
+		}
 	}
 
 	return true;
@@ -1752,6 +1718,7 @@ void Simulation::kill_part(int i)//kills particle number i
 			pmap[y][x] = 0;
 		else if (photons[y][x] && ID(photons[y][x]) == i)
 			photons[y][x] = 0;
+		WakeBlock(x, y);
 	}
 
 	// This shouldn't happen but ... you never know?
@@ -1760,6 +1727,7 @@ void Simulation::kill_part(int i)//kills particle number i
 
 	elementCount[t]--;
 
+	partGenerations[i] += 1;
 	parts.Free(i);
 	NUM_PARTS -= 1;
 }
@@ -1801,15 +1769,18 @@ bool Simulation::part_change_type(int i, int x, int y, int t)
 	elementCount[t]++;
 
 	parts[i].type = t;
+	WakeBlock(x, y);
 	if (elements[t].Properties & TYPE_ENERGY)
 	{
 		photons[y][x] = PMAP(i, t);
+		MarkPhotons(x, y);
 		if (pmap[y][x] && ID(pmap[y][x]) == i)
 			pmap[y][x] = 0;
 	}
 	else
 	{
 		pmap[y][x] = PMAP(i, t);
+		MarkPmap(x, y);
 		if (photons[y][x] && ID(photons[y][x]) == i)
 			photons[y][x] = 0;
 	}
@@ -1847,6 +1818,7 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 		parts[index].life = 4;
 		parts[index].ctype = type;
 		pmap[y][x] = (pmap[y][x]&~PMAPMASK) | PT_SPRK;
+		WakeBlock(x, y);
 		if (parts[index].temp+10.0f < 673.0f && !legacy_enable && (type==PT_METL || type == PT_BMTL || type == PT_BRMT || type == PT_PSCN || type == PT_NSCN || type == PT_ETRD || type == PT_NBLE || type == PT_IRON))
 			parts[index].temp = parts[index].temp+10.0f;
 		return index;
@@ -1920,10 +1892,17 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 	parts[i].y = (float)y;
 
 	//and finally set the pmap/photon maps to the newly created particle
+	WakeBlock(x, y);
 	if (elements[t].Properties & TYPE_ENERGY)
+	{
 		photons[y][x] = PMAP(i, t);
+		MarkPhotons(x, y);
+	}
 	else if (t!=PT_STKM && t!=PT_STKM2 && t!=PT_FIGH)
+	{
 		pmap[y][x] = PMAP(i, t);
+		MarkPmap(x, y);
+	}
 
 	//Fancy dust effects for powder types
 	if((elements[t].Properties & TYPE_PART) && pretty_powder)
@@ -2137,6 +2116,12 @@ Simulation::PlanMoveResult Simulation::PlanMove(Sim &sim, int i, int x, int y)
 		fin_x = (int)(fin_xf+0.5f);
 		fin_y = (int)(fin_yf+0.5f);
 		bool closedEholeStart = InBounds(fin_x, fin_y) && (bmap[fin_y/CELL][fin_x/CELL] == WL_EHOLE && !emap[fin_y/CELL][fin_x/CELL]);
+		// a pixel in a block with no walls and no pmap entries is never an obstacle, unless the
+		// particle can't move through empty space at all or started in a closed ehole; such pixels
+		// can skip eval_move entirely, the march still steps through them one at a time so it stops
+		// at exactly the same place
+		auto emptyMove = can_move[t][PT_NONE];
+		bool skipEmptyBlocks = (emptyMove == 1 || emptyMove == 2) && !closedEholeStart;
 		while (1)
 		{
 			mv -= ISTP;
@@ -2177,6 +2162,10 @@ Simulation::PlanMoveResult Simulation::PlanMove(Sim &sim, int i, int x, int y)
 				clear_y = (int)(clear_yf+0.5f);
 				break;
 			}
+			if (skipEmptyBlocks && InBounds(fin_x, fin_y) && !bmap[fin_y/CELL][fin_x/CELL] && !sim.pmapOccupied[fin_y/CELL][fin_x/CELL])
+			{
+				continue;
+			}
 			//block if particle can't move (0), or some special cases where it returns 1 (can_move = 3 but returns 1 meaning particle will be eaten)
 			//also photons are still blocked (slowed down) by any particle (even ones it can move through), and absorb wall also blocks particles
 			int eval = sim.eval_move(t, fin_x, fin_y, nullptr);
@@ -2219,7 +2208,7 @@ Simulation::Neighbourhood Simulation::GetNeighbourhood(int i) const
 	auto x = int(parts[i].x + 0.5f);
 	auto y = int(parts[i].y + 0.5f);
 	auto &sd = SimulationData::CRef();
-	auto &elements = sd.elements;
+	auto &hot = sd.hotElements;
 	Neighbourhood n;
 	auto j = 0;
 	for (auto nx=-1; nx<2; nx++)
@@ -2236,9 +2225,9 @@ Simulation::Neighbourhood Simulation::GetNeighbourhood(int i) const
 			}
 		}
 	}
-	if (!(elements[t].Properties & TYPE_SOLID) && (elements[t].Gravity || elements[t].NewtonianGravity))
+	if (!(hot[t].Properties & TYPE_SOLID) && (hot[t].Gravity || hot[t].NewtonianGravity))
 	{
-		GetGravityField(x, y, elements[t].Gravity, elements[t].NewtonianGravity, n.pGravX, n.pGravY);
+		GetGravityField(x, y, hot[t].Gravity, hot[t].NewtonianGravity, n.pGravX, n.pGravY);
 	}
 	return n;
 }
@@ -2247,7 +2236,7 @@ void Simulation::UpdateParticles(int start, int end)
 {
 	//the main particle loop function, goes over all particles.
 	auto &sd = SimulationData::CRef();
-	auto &elements = sd.elements;
+	auto &hot = sd.hotElements;
 	for (auto i = start; i < end && i < parts.active; i++)
 	{
 		auto t = parts[i].type;
@@ -2273,10 +2262,10 @@ void Simulation::UpdateParticles(int start, int end)
 		    bmap[y/CELL][x/CELL]==WL_WALLELEC ||
 		    bmap[y/CELL][x/CELL]==WL_ALLOWAIR ||
 		    (bmap[y/CELL][x/CELL]==WL_DESTROYALL) ||
-		    (bmap[y/CELL][x/CELL]==WL_ALLOWLIQUID && !(elements[t].Properties&TYPE_LIQUID)) ||
-		    (bmap[y/CELL][x/CELL]==WL_ALLOWPOWDER && !(elements[t].Properties&TYPE_PART)) ||
-		    (bmap[y/CELL][x/CELL]==WL_ALLOWGAS && !(elements[t].Properties&TYPE_GAS)) || //&& elements[t].Falldown!=0 && parts[i].type!=PT_FIRE && parts[i].type!=PT_SMKE && parts[i].type!=PT_CFLM) ||
-		            (bmap[y/CELL][x/CELL]==WL_ALLOWENERGY && !(elements[t].Properties&TYPE_ENERGY)) ||
+		    (bmap[y/CELL][x/CELL]==WL_ALLOWLIQUID && !(hot[t].Properties&TYPE_LIQUID)) ||
+		    (bmap[y/CELL][x/CELL]==WL_ALLOWPOWDER && !(hot[t].Properties&TYPE_PART)) ||
+		    (bmap[y/CELL][x/CELL]==WL_ALLOWGAS && !(hot[t].Properties&TYPE_GAS)) || //&& hot[t].Falldown!=0 && parts[i].type!=PT_FIRE && parts[i].type!=PT_SMKE && parts[i].type!=PT_CFLM) ||
+		            (bmap[y/CELL][x/CELL]==WL_ALLOWENERGY && !(hot[t].Properties&TYPE_ENERGY)) ||
 		    (bmap[y/CELL][x/CELL]==WL_EWALL && !emap[y/CELL][x/CELL])) && (t!=PT_STKM) && (t!=PT_STKM2) && (t!=PT_FIGH))
 		{
 			kill_part(i);
@@ -2291,36 +2280,48 @@ void Simulation::UpdateParticles(int start, int end)
 		if (bmap[y/CELL][x/CELL]==WL_DETECT && emap[y/CELL][x/CELL]<8)
 			set_emap(x/CELL, y/CELL);
 
+		// Elements with their own update logic never sleep; anything else in a sleeping block
+		// has nothing to do until something wakes the block up again.
+		if (hot[t].Update || hot[t].HotAir || hot[t].Diffusion || legacy_enable)
+		{
+			WakeBlock(x, y);
+		}
+		else if (BlockAsleep(x, y))
+		{
+			continue;
+		}
+		auto oldTemp = parts[i].temp;
+
 		//adding to velocity from the particle's velocity
-		vx[y/CELL][x/CELL] = vx[y/CELL][x/CELL]*elements[t].AirLoss + elements[t].AirDrag*parts[i].vx;
-		vy[y/CELL][x/CELL] = vy[y/CELL][x/CELL]*elements[t].AirLoss + elements[t].AirDrag*parts[i].vy;
+		vx[y/CELL][x/CELL] = vx[y/CELL][x/CELL]*hot[t].AirLoss + hot[t].AirDrag*parts[i].vx;
+		vy[y/CELL][x/CELL] = vy[y/CELL][x/CELL]*hot[t].AirLoss + hot[t].AirDrag*parts[i].vy;
 
-		if (elements[t].HotAir)
+		if (hot[t].HotAir)
 		{
 			if (t==PT_GAS||t==PT_NBLE)
 			{
 				if (pv[y/CELL][x/CELL]<3.5f)
-					pv[y/CELL][x/CELL] += elements[t].HotAir*(3.5f-pv[y/CELL][x/CELL]);
+					pv[y/CELL][x/CELL] += hot[t].HotAir*(3.5f-pv[y/CELL][x/CELL]);
 				if (y+CELL<YRES && pv[y/CELL+1][x/CELL]<3.5f)
-					pv[y/CELL+1][x/CELL] += elements[t].HotAir*(3.5f-pv[y/CELL+1][x/CELL]);
+					pv[y/CELL+1][x/CELL] += hot[t].HotAir*(3.5f-pv[y/CELL+1][x/CELL]);
 				if (x+CELL<XRES)
 				{
 					if (pv[y/CELL][x/CELL+1]<3.5f)
-						pv[y/CELL][x/CELL+1] += elements[t].HotAir*(3.5f-pv[y/CELL][x/CELL+1]);
+						pv[y/CELL][x/CELL+1] += hot[t].HotAir*(3.5f-pv[y/CELL][x/CELL+1]);
 					if (y+CELL<YRES && pv[y/CELL+1][x/CELL+1]<3.5f)
-						pv[y/CELL+1][x/CELL+1] += elements[t].HotAir*(3.5f-pv[y/CELL+1][x/CELL+1]);
+						pv[y/CELL+1][x/CELL+1] += hot[t].HotAir*(3.5f-pv[y/CELL+1][x/CELL+1]);
 				}
 			}
 			else//add the hotair variable to the pressure map, like black hole, or white hole.
 			{
-				pv[y/CELL][x/CELL] += elements[t].HotAir;
+				pv[y/CELL][x/CELL] += hot[t].HotAir;
 				if (y+CELL<YRES)
-					pv[y/CELL+1][x/CELL] += elements[t].HotAir;
+					pv[y/CELL+1][x/CELL] += hot[t].HotAir;
 				if (x+CELL<XRES)
 				{
-					pv[y/CELL][x/CELL+1] += elements[t].HotAir;
+					pv[y/CELL][x/CELL+1] += hot[t].HotAir;
 					if (y+CELL<YRES)
-						pv[y/CELL+1][x/CELL+1] += elements[t].HotAir;
+						pv[y/CELL+1][x/CELL+1] += hot[t].HotAir;
 				}
 			}
 		}
@@ -2330,18 +2331,18 @@ void Simulation::UpdateParticles(int start, int end)
 		//velocity updates for the particle
 		if (t != PT_SPNG || !(parts[i].flags&FLAG_MOVABLE))
 		{
-			parts[i].vx *= elements[t].Loss;
-			parts[i].vy *= elements[t].Loss;
+			parts[i].vx *= hot[t].Loss;
+			parts[i].vy *= hot[t].Loss;
 		}
 		//particle gets velocity from the vx and vy maps
-		parts[i].vx += elements[t].Advection*vx[y/CELL][x/CELL] + neighbourhood.pGravX;
-		parts[i].vy += elements[t].Advection*vy[y/CELL][x/CELL] + neighbourhood.pGravY;
+		parts[i].vx += hot[t].Advection*vx[y/CELL][x/CELL] + neighbourhood.pGravX;
+		parts[i].vy += hot[t].Advection*vy[y/CELL][x/CELL] + neighbourhood.pGravY;
 
 
-		if (elements[t].Diffusion)//the random diffusion that gasses have
+		if (hot[t].Diffusion)//the random diffusion that gasses have
 		{
-			parts[i].vx += elements[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
-			parts[i].vy += elements[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
+			parts[i].vx += hot[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
+			parts[i].vy += hot[t].Diffusion*(2.0f*rng.uniform01()-1.0f);
 		}
 
 		auto transitionOccurred = TransitionPhase(i, neighbourhood);
@@ -2353,11 +2354,15 @@ void Simulation::UpdateParticles(int start, int end)
 		{
 			t = parts[i].type;
 		}
+		if (transitionOccurred || std::abs(parts[i].temp - oldTemp) > sleepEpsilon)
+		{
+			WakeBlock(x, y);
+		}
 
 		//call the particle update function, if there is one
-		if (elements[t].Update)
+		if (hot[t].Update)
 		{
-			if ((*(elements[t].Update))(this, i, x, y, neighbourhood.surround_space, neighbourhood.nt, parts, pmap))
+			if ((*(hot[t].Update))(this, i, x, y, neighbourhood.surround_space, neighbourhood.nt, parts, pmap))
 				continue;
 			x = int(parts[i].x+0.5f);
 			y = int(parts[i].y+0.5f);
@@ -2383,6 +2388,8 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 {
 	auto &sd = SimulationData::CRef();
 	auto &elements = sd.elements;
+	auto &hot = sd.hotElements;
+	auto &transitions = sd.hotTransitions;
 
 	auto t = parts[i].type;
 	auto x = int(parts[i].x + 0.5f);
@@ -2394,7 +2401,7 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 		if (t==PT_GEL)
 			gel_scale = parts[i].tmp*2.55f;
 
-		if ((elements[t].Properties&TYPE_LIQUID) && (t!=PT_GEL || gel_scale > (1 + rng.between(0, 254))))
+		if ((hot[t].Properties&TYPE_LIQUID) && (t!=PT_GEL || gel_scale > (1 + rng.between(0, 254))))
 		{
 			float convGravX, convGravY;
 			GetGravityField(x, y, -2.0f, -2.0f, convGravX, convGravY);
@@ -2417,83 +2424,93 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 		}
 
 		// Heat transfer code
-		if (t && !sd.IsHeatInsulator(parts[i]) && rng.chance(int(elements[t].HeatConduct*gel_scale), 250))
+		// With grid heat, conduction between particles has already happened in UpdateGridHeat, the
+		// rest of this runs every frame and exchange with air is scaled by the chance it would have had.
+		if (t && !sd.IsHeatInsulator(parts[i]) && (gridHeat || rng.chance(int(hot[t].HeatConduct*gel_scale), 250)))
 		{
 			// Heat transfer with air
-			if (aheat_enable && !(elements[t].Properties&PROP_NOAMBHEAT))
+			if (aheat_enable && !(hot[t].Properties&PROP_NOAMBHEAT))
 			{
 				auto dtemp = hv[y/CELL][x/CELL] - parts[i].temp; // Temperature difference
-				auto alpha = std::min(0.04f, 0.4f * elements[t].HeatCapacity); // alpha / heat_capacity must be < 1
+				auto alpha = std::min(0.04f, 0.4f * hot[t].HeatCapacity); // alpha / heat_capacity must be < 1
+				if (gridHeat)
+				{
+					alpha *= std::clamp(hot[t].HeatConduct * gel_scale / 250.0f, 0.0f, 1.0f);
+				}
 
 				// Here we completely ignore that there are CELL^2 "air pixels" in a cell, and the heat capacity of air
-				parts[i].temp = restrict_flt(parts[i].temp + alpha*dtemp / elements[t].HeatCapacity, MIN_TEMP, MAX_TEMP);
+				parts[i].temp = restrict_flt(parts[i].temp + alpha*dtemp / hot[t].HeatCapacity, MIN_TEMP, MAX_TEMP);
 				hv[y/CELL][x/CELL] = restrict_flt(hv[y/CELL][x/CELL] - alpha*dtemp, MIN_TEMP, MAX_TEMP);
 			}
 
 			// Heat transfer with other elements
-			auto hc_total = 0.0f; // Total heat capacity of elements involved
-			auto c_heat = 0.0f; // Total heat distributed between elements
-			int surround_hconduct[8]; // IDs of elements which exchange heat
-
-			for (auto j=0; j<8; j++)
+			float pt = parts[i].temp;
+			if (!gridHeat)
 			{
-				surround_hconduct[j] = i;
-				auto r = neighbourhood.surround[j];
+				auto hc_total = 0.0f; // Total heat capacity of elements involved
+				auto c_heat = 0.0f; // Total heat distributed between elements
+				int surround_hconduct[8]; // IDs of elements which exchange heat
 
-				if (!r)
-					continue;
+				for (auto j=0; j<8; j++)
+				{
+					surround_hconduct[j] = i;
+					auto r = neighbourhood.surround[j];
 
-				auto rt = TYP(r);
+					if (!r)
+						continue;
 
-				// Check if we can conduct heat
-				if (!rt || sd.IsHeatInsulator(parts[ID(r)])
-				        || (t == PT_FILT && (rt == PT_BRAY || rt == PT_BIZR || rt == PT_BIZRG))
-				        || (rt == PT_FILT && (t == PT_BRAY || t == PT_PHOT || t == PT_BIZR || t == PT_BIZRG))
-				        || (t == PT_ELEC && rt == PT_DEUT)
-				        || (t == PT_DEUT && rt == PT_ELEC)
-				        || (t == PT_HSWC && rt == PT_FILT && parts[i].tmp == 1)
-				        || (t == PT_FILT && rt == PT_HSWC && parts[ID(r)].tmp == 1))
-					continue;
+					auto rt = TYP(r);
 
-				surround_hconduct[j] = ID(r);
-				c_heat += parts[ID(r)].temp*elements[rt].HeatCapacity;
-				hc_total += elements[rt].HeatCapacity;
+					// Check if we can conduct heat
+					if (!rt || sd.IsHeatInsulator(parts[ID(r)])
+					        || (t == PT_FILT && (rt == PT_BRAY || rt == PT_BIZR || rt == PT_BIZRG))
+					        || (rt == PT_FILT && (t == PT_BRAY || t == PT_PHOT || t == PT_BIZR || t == PT_BIZRG))
+					        || (t == PT_ELEC && rt == PT_DEUT)
+					        || (t == PT_DEUT && rt == PT_ELEC)
+					        || (t == PT_HSWC && rt == PT_FILT && parts[i].tmp == 1)
+					        || (t == PT_FILT && rt == PT_HSWC && parts[ID(r)].tmp == 1))
+						continue;
 
-				// Double count the particle to account for the heat capacity of both the PIPE/PPIP and its contents
-				if ((rt == PT_PIPE || rt == PT_PPIP) && parts[ID(r)].ctype != 0)
-				{
-					c_heat += parts[ID(r)].temp*elements[rt].HeatCapacity;
-					hc_total += elements[rt].HeatCapacity;
+					surround_hconduct[j] = ID(r);
+					c_heat += parts[ID(r)].temp*hot[rt].HeatCapacity;
+					hc_total += hot[rt].HeatCapacity;
+
+					// Double count the particle to account for the heat capacity of both the PIPE/PPIP and its contents
+					if ((rt == PT_PIPE || rt == PT_PPIP) && parts[ID(r)].ctype != 0)
+					{
+						c_heat += parts[ID(r)].temp*hot[rt].HeatCapacity;
+						hc_total += hot[rt].HeatCapacity;
+					}
 				}
-			}
 
-			// Add the current particle
-			c_heat += parts[i].temp*elements[t].HeatCapacity;
-			hc_total += elements[t].HeatCapacity;
+				// Add the current particle
+				c_heat += parts[i].temp*hot[t].HeatCapacity;
+				hc_total += hot[t].HeatCapacity;
 
-			// Double count the current particle to account for the heat capacity of both the PIPE/PPIP and its contents
-			if ((t == PT_PIPE || t == PT_PPIP) && parts[i].ctype != 0)
-			{
-				c_heat += parts[i].temp*elements[t].HeatCapacity;
-				hc_total += elements[t].HeatCapacity;
-			}
+				// Double count the current particle to account for the heat capacity of both the PIPE/PPIP and its contents
+				if ((t == PT_PIPE || t == PT_PPIP) && parts[i].ctype != 0)
+				{
+					c_heat += parts[i].temp*hot[t].HeatCapacity;
+					hc_total += hot[t].HeatCapacity;
+				}
 
-			// Equilibrium temperature
-			float pt = restrict_flt(c_heat / hc_total, MIN_TEMP, MAX_TEMP);
+				// Equilibrium temperature
+				pt = restrict_flt(c_heat / hc_total, MIN_TEMP, MAX_TEMP);
 
-			parts[i].temp = pt;
-			for (auto j=0; j<8; j++)
-			{
-				parts[surround_hconduct[j]].temp = pt;
+				parts[i].temp = pt;
+				for (auto j=0; j<8; j++)
+				{
+					parts[surround_hconduct[j]].temp = pt;
+				}
 			}
 
 			auto ctemph = pt;
 			auto ctempl = pt;
 			// change boiling point with pressure
-			if (((elements[t].Properties&TYPE_LIQUID) && sd.IsElementOrNone(elements[t].HighTemperatureTransition) && (elements[elements[t].HighTemperatureTransition].Properties&TYPE_GAS))
+			if (((hot[t].Properties&TYPE_LIQUID) && sd.IsElementOrNone(transitions[t].HighTemperatureTransition) && (hot[transitions[t].HighTemperatureTransition].Properties&TYPE_GAS))
 			        || t==PT_LNTG || t==PT_SLTW)
 				ctemph -= 2.0f*pv[y/CELL][x/CELL];
-			else if (((elements[t].Properties&TYPE_GAS) && sd.IsElementOrNone(elements[t].LowTemperatureTransition) && (elements[elements[t].LowTemperatureTransition].Properties&TYPE_LIQUID))
+			else if (((hot[t].Properties&TYPE_GAS) && sd.IsElementOrNone(transitions[t].LowTemperatureTransition) && (hot[transitions[t].LowTemperatureTransition].Properties&TYPE_LIQUID))
 			         || t==PT_WTRV)
 				ctempl -= 2.0f*pv[y/CELL][x/CELL];
 			auto s = 1;
@@ -2502,12 +2519,12 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 			if ((t==PT_ICEI || t==PT_SNOW) && (!sd.IsElement(parts[i].ctype) || parts[i].ctype==PT_ICEI || parts[i].ctype==PT_SNOW))
 				parts[i].ctype = PT_WATR;
 
-			if (elements[t].HighTemperatureTransition != NT && ctemph>=elements[t].HighTemperature)
+			if (transitions[t].HighTemperatureTransition != NT && ctemph>=transitions[t].HighTemperature)
 			{
 				// particle type change due to high temperature
-				if (elements[t].HighTemperatureTransition != ST)
+				if (transitions[t].HighTemperatureTransition != ST)
 				{
-					t = elements[t].HighTemperatureTransition;
+					t = transitions[t].HighTemperatureTransition;
 				}
 				else if (t == PT_ICEI || t == PT_SNOW)
 				{
@@ -2547,7 +2564,7 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 							parts[i].type = PT_TUNG;
 						}
 					}
-					else if (ctemph >= elements[t].HighTemperature)
+					else if (ctemph >= transitions[t].HighTemperature)
 						t = PT_LAVA;
 					else
 						s = 0;
@@ -2576,12 +2593,12 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 				else
 					s = 0;
 			}
-			else if (elements[t].LowTemperatureTransition != NT && ctempl<elements[t].LowTemperature)
+			else if (transitions[t].LowTemperatureTransition != NT && ctempl<transitions[t].LowTemperature)
 			{
 				// particle type change due to low temperature
-				if (elements[t].LowTemperatureTransition != ST)
+				if (transitions[t].LowTemperatureTransition != ST)
 				{
-					t = elements[t].LowTemperatureTransition;
+					t = transitions[t].LowTemperatureTransition;
 				}
 				else if (t == PT_WTRV)
 				{
@@ -2655,7 +2672,7 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 					//and I don't feel like checking each one right now
 					parts[i].tmp = 0;
 				}
-				if ((elements[t].Properties&TYPE_GAS) && !(elements[parts[i].type].Properties&TYPE_GAS))
+				if ((hot[t].Properties&TYPE_GAS) && !(hot[parts[i].type].Properties&TYPE_GAS))
 					pv[y/CELL][x/CELL] += 0.50f;
 
 				if (t == PT_NONE)
@@ -2712,7 +2729,7 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 		parts[i].temp = restrict_flt(parts[i].temp-50.0f, MIN_TEMP, MAX_TEMP);
 	}
 	//spark updates from walls
-	if ((elements[t].Properties&PROP_CONDUCTS) || t==PT_SPRK)
+	if ((hot[t].Properties&PROP_CONDUCTS) || t==PT_SPRK)
 	{
 		auto nx = x % CELL;
 		if (nx == 0)
@@ -2759,10 +2776,10 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 		auto s = 1;
 		auto gravtot = std::abs(gravOut.forceX[Vec2{ x, y } / CELL]) +
 		               std::abs(gravOut.forceY[Vec2{ x, y } / CELL]);
-		if (elements[t].HighPressureTransition != NT && pv[y/CELL][x/CELL]>elements[t].HighPressure) {
+		if (transitions[t].HighPressureTransition != NT && pv[y/CELL][x/CELL]>transitions[t].HighPressure) {
 			// particle type change due to high pressure
-			if (elements[t].HighPressureTransition != ST)
-				t = elements[t].HighPressureTransition;
+			if (transitions[t].HighPressureTransition != ST)
+				t = transitions[t].HighPressureTransition;
 			else if (t==PT_BMTL) {
 				if (pv[y/CELL][x/CELL]>2.5f)
 					t = PT_BRMT;
@@ -2771,15 +2788,15 @@ bool Simulation::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 				else s = 0;
 			}
 			else s = 0;
-		} else if (elements[t].LowPressureTransition != NT && pv[y/CELL][x/CELL]<elements[t].LowPressure && gravtot<=(elements[t].LowPressure/4.0f)) {
+		} else if (transitions[t].LowPressureTransition != NT && pv[y/CELL][x/CELL]<transitions[t].LowPressure && gravtot<=(transitions[t].LowPressure/4.0f)) {
 			// particle type change due to low pressure
-			if (elements[t].LowPressureTransition != ST)
-				t = elements[t].LowPressureTransition;
+			if (transitions[t].LowPressureTransition != ST)
+				t = transitions[t].LowPressureTransition;
 			else s = 0;
-		} else if (elements[t].HighPressureTransition != NT && gravtot>(elements[t].HighPressure/4.0f)) {
+		} else if (transitions[t].HighPressureTransition != NT && gravtot>(transitions[t].HighPressure/4.0f)) {
 			// particle type change due to high gravity
-			if (elements[t].HighPressureTransition != ST)
-				t = elements[t].HighPressureTransition;
+			if (transitions[t].HighPressureTransition != ST)
+				t = transitions[t].HighPressureTransition;
 			else if (t==PT_BMTL) {
 				if (gravtot>0.625f)
 					t = PT_BRMT;
@@ -2816,6 +2833,7 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 {
 	auto &sd = SimulationData::CRef();
 	auto &elements = sd.elements;
+	auto &hot = sd.hotElements;
 
 	auto t = parts[i].type;
 	auto x = int(parts[i].x+0.5f);
@@ -2896,13 +2914,19 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 				kill_part(i);
 				return;
 			}
-			if (elements[t].Properties & TYPE_ENERGY)
+			if (hot[t].Properties & TYPE_ENERGY)
+			{
 				photons[ny][nx] = PMAP(i, t);
+				MarkPhotons(nx, ny);
+			}
 			else if (t)
+			{
 				pmap[ny][nx] = PMAP(i, t);
+				MarkPmap(nx, ny);
+			}
 		}
 	}
-	else if (elements[t].Properties & TYPE_ENERGY)
+	else if (hot[t].Properties & TYPE_ENERGY)
 	{
 		if (t == PT_PHOT)
 		{
@@ -3037,7 +3061,7 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 			}
 		}
 	}
-	else if (elements[t].Falldown==0)
+	else if (hot[t].Falldown==0)
 	{
 		// gasses and solids (but not powders)
 		if (!do_move(i, x, y, fin_xf, fin_yf))
@@ -3051,23 +3075,23 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 			if (fin_y<y-ISTP) fin_y=y-ISTP;
 			if (do_move(i, x, y, (float)(2*x-fin_x), fin_y))
 			{
-				parts[i].vx *= elements[t].Collision;
+				parts[i].vx *= hot[t].Collision;
 			}
 			else if (do_move(i, x, y, fin_x, (float)(2*y-fin_y)))
 			{
-				parts[i].vy *= elements[t].Collision;
+				parts[i].vy *= hot[t].Collision;
 			}
 			else
 			{
-				parts[i].vx *= elements[t].Collision;
-				parts[i].vy *= elements[t].Collision;
+				parts[i].vx *= hot[t].Collision;
+				parts[i].vy *= hot[t].Collision;
 			}
 		}
 	}
 	else
 	{
 		// Checking stagnant is cool, but then it doesn't update when you change it later.
-		if (water_equal_test && elements[t].Falldown == 2 && rng.chance(1, 200))
+		if (water_equal_test && hot[t].Falldown == 2 && rng.chance(1, 200))
 		{
 			if (flood_water(x, y, i))
 				return;
@@ -3079,13 +3103,13 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 				return;
 			if (fin_x!=x && do_move(i, x, y, fin_xf, clear_yf))
 			{
-				parts[i].vx *= elements[t].Collision;
-				parts[i].vy *= elements[t].Collision;
+				parts[i].vx *= hot[t].Collision;
+				parts[i].vy *= hot[t].Collision;
 			}
 			else if (fin_y!=y && do_move(i, x, y, clear_xf, fin_yf))
 			{
-				parts[i].vx *= elements[t].Collision;
-				parts[i].vy *= elements[t].Collision;
+				parts[i].vx *= hot[t].Collision;
+				parts[i].vy *= hot[t].Collision;
 			}
 			else
 			{
@@ -3105,8 +3129,8 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 					dy /= mv;
 					if (do_move(i, x, y, clear_xf+dx, clear_yf+dy))
 					{
-						parts[i].vx *= elements[t].Collision;
-						parts[i].vy *= elements[t].Collision;
+						parts[i].vx *= hot[t].Collision;
+						parts[i].vy *= hot[t].Collision;
 						return;
 					}
 					{
@@ -3116,12 +3140,12 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 					}
 					if (do_move(i, x, y, clear_xf+dx, clear_yf+dy))
 					{
-						parts[i].vx *= elements[t].Collision;
-						parts[i].vy *= elements[t].Collision;
+						parts[i].vx *= hot[t].Collision;
+						parts[i].vy *= hot[t].Collision;
 						return;
 					}
 				}
-				if (elements[t].Falldown>1 && !grav && gravityMode==GRAV_VERTICAL && parts[i].vy>fabsf(parts[i].vx))
+				if (hot[t].Falldown>1 && !grav && gravityMode==GRAV_VERTICAL && parts[i].vy>fabsf(parts[i].vx))
 				{
 					auto s = 0;
 					// stagnant is true if FLAG_STAGNANT was set for this particle in previous frame
@@ -3168,12 +3192,12 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 					else if (s==-1) {} // particle is out of bounds
 					else if ((clear_x!=x||clear_y!=y) && do_move(i, x, y, clear_xf, clear_yf)) {}
 					else parts[i].flags |= FLAG_STAGNANT;
-					parts[i].vx *= elements[t].Collision;
-					parts[i].vy *= elements[t].Collision;
+					parts[i].vx *= hot[t].Collision;
+					parts[i].vy *= hot[t].Collision;
 				}
-				else if (elements[t].Falldown>1 && fabsf(pGravX*parts[i].vx+pGravY*parts[i].vy)>fabsf(pGravY*parts[i].vx-pGravX*parts[i].vy))
+				else if (hot[t].Falldown>1 && fabsf(pGravX*parts[i].vx+pGravY*parts[i].vy)>fabsf(pGravY*parts[i].vx-pGravX*parts[i].vy))
 				{
-					float nxf, nyf, prev_pGravX, prev_pGravY, ptGrav = elements[t].Gravity;
+					float nxf, nyf, prev_pGravX, prev_pGravY, ptGrav = hot[t].Gravity;
 					auto s = 0;
 					// stagnant is true if FLAG_STAGNANT was set for this particle in previous frame
 					// nt is if there is something else besides the current particle type around the particle
@@ -3266,16 +3290,16 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 					else if (s==-1) {} // particle is out of bounds
 					else if ((clear_x!=x||clear_y!=y) && do_move(i, x, y, clear_xf, clear_yf)) {} // try moving to the last clear position
 					else parts[i].flags |= FLAG_STAGNANT;
-					parts[i].vx *= elements[t].Collision;
-					parts[i].vy *= elements[t].Collision;
+					parts[i].vx *= hot[t].Collision;
+					parts[i].vy *= hot[t].Collision;
 				}
 				else
 				{
 					// if interpolation was done, try moving to last clear position
 					if ((clear_x!=x||clear_y!=y) && do_move(i, x, y, clear_xf, clear_yf)) {}
 					else parts[i].flags |= FLAG_STAGNANT;
-					parts[i].vx *= elements[t].Collision;
-					parts[i].vy *= elements[t].Collision;
+					parts[i].vx *= hot[t].Collision;
+					parts[i].vy *= hot[t].Collision;
 				}
 			}
 		}
@@ -3285,8 +3309,10 @@ void Simulation::MovementPhase(int i, Neighbourhood neighbourhood)
 void Simulation::RecalcFreeParticles(bool do_life_dec)
 {
 	memset(pmap, 0, sizeof(pmap));
+	memset(pmapOccupied, 0, sizeof(pmapOccupied));
 	memset(pmap_count, 0, sizeof(pmap_count));
 	memset(photons, 0, sizeof(photons));
+	memset(photonsOccupied, 0, sizeof(photonsOccupied));
 
 	NUM_PARTS = 0;
 	auto &sd = SimulationData::CRef();
@@ -3305,13 +3331,19 @@ void Simulation::RecalcFreeParticles(bool do_life_dec)
 		if (x>=0 && y>=0 && x<XRES && y<YRES)
 		{
 			if (elements[t].Properties & TYPE_ENERGY)
+			{
 				photons[y][x] = PMAP(i, t);
+				MarkPhotons(x, y);
+			}
 			else
 			{
 				// Particles are sometimes allowed to go inside INVS and FILT
 				// To make particles collide correctly when inside these elements, these elements must not overwrite an existing pmap entry from particles inside them
 				if (!pmap[y][x] || (t!=PT_INVIS && t!= PT_FILT))
+				{
 					pmap[y][x] = PMAP(i, t);
+					MarkPmap(x, y);
+				}
 				// (there are a few exceptions, including energy particles - currently no limit on stacking those)
 				if (t!=PT_THDR && t!=PT_EMBR && t!=PT_FIGH && t!=PT_PLSM)
 					pmap_count[y][x]++;
@@ -3377,10 +3409,151 @@ void Parts::Flatten()
 	active = newActive;
 }
 
+// Fast path for when every living cell in the GOL space shares the same builtin
+// ruleset, which is by far the most common case. Produces exactly the same
+// results as the general path below, including particle creation order and
+// colour sampling; returns false without touching anything if the field doesn't
+// qualify.
+bool Simulation::SimulateGoLBitboard()
+{
+	auto &builtinGol = SimulationData::builtinGol;
+	auto &board = *golBitboard;
+	board.Clear();
+	std::optional<int> kind;
+	std::vector<int> dying;
+	for (int i = 0; i < parts.active; ++i)
+	{
+		auto &part = parts[i];
+		if (part.type != PT_LIFE)
+		{
+			continue;
+		}
+		auto x = int(part.x + 0.5f);
+		auto y = int(part.y + 0.5f);
+		if (x < CELL || y < CELL || x >= XRES - CELL || y >= YRES - CELL)
+		{
+			continue;
+		}
+		unsigned int ruleset = part.ctype;
+		if (ruleset < NGOL)
+		{
+			ruleset = builtinGol[ruleset].ruleset;
+		}
+		if (part.tmp2 != int((ruleset >> 17) & 0xF) + 1)
+		{
+			// * Cells that are already dying don't interact with anything,
+			//   whatever their ruleset.
+			dying.push_back(i);
+			continue;
+		}
+		// * Living cells must all be of the same builtin kind, and must be the
+		//   ones pmap sees, as that's what the general path looks at.
+		if (unsigned(part.ctype) >= NGOL || (kind && *kind != part.ctype) || pmap[y][x] != PMAP(i, PT_LIFE))
+		{
+			return false;
+		}
+		kind = part.ctype;
+		board.Set(x - CELL, y - CELL);
+	}
+	auto inStasis = [this](int x, int y) {
+		return bmap[y / CELL][x / CELL] == WL_STASIS && emap[y / CELL][x / CELL] < 8;
+	};
+	std::vector<std::pair<int, int>> toKill;
+	for (auto i : dying)
+	{
+		auto &part = parts[i];
+		auto x = int(part.x + 0.5f);
+		auto y = int(part.y + 0.5f);
+		if (!inStasis(x, y))
+		{
+			part.tmp2 -= 1;
+		}
+		if (part.tmp2 <= 0)
+		{
+			toKill.push_back({ y * XRES + x, i });
+		}
+	}
+	if (kind)
+	{
+		auto ruleset = builtinGol[*kind].ruleset;
+		board.Step(ruleset);
+		for (int by = 0; by < GOLBitboard::height; ++by)
+		{
+			auto &changes = board.Changes(by);
+			for (int w = 0; w < GOLBitboard::words; ++w)
+			{
+				for (auto bits = changes[w]; bits; bits &= bits - 1)
+				{
+					auto bx = w * 64 + std::countr_zero(bits) - 1;
+					auto x = bx + CELL;
+					auto y = by + CELL;
+					if (inStasis(x, y))
+					{
+						continue;
+					}
+					if (board.Get(bx, by))
+					{
+						// * Start death sequence.
+						auto i = ID(pmap[y][x]);
+						parts[i].tmp2 -= 1;
+						if (parts[i].tmp2 <= 0)
+						{
+							toKill.push_back({ y * XRES + x, i });
+						}
+						continue;
+					}
+					if (pmap[y][x])
+					{
+						continue;
+					}
+					// * The general path samples colours from the living neighbour
+					//   that was processed first, i.e. the one with the lowest index.
+					int sampleID = -1;
+					for (int yy = -1; yy <= 1; ++yy)
+					{
+						for (int xx = -1; xx <= 1; ++xx)
+						{
+							int ax = ((x + xx + XRES - 3 * CELL) % (XRES - 2 * CELL)) + CELL;
+							int ay = ((y + yy + YRES - 3 * CELL) % (YRES - 2 * CELL)) + CELL;
+							if ((xx || yy) && board.Get(ax - CELL, ay - CELL) && (sampleID < 0 || ID(pmap[ay][ax]) < sampleID))
+							{
+								sampleID = ID(pmap[ay][ax]);
+							}
+						}
+					}
+					// * 0x200000: No need to look for colours, they'll be set later anyway.
+					int i = create_part(-1, x, y, PT_LIFE, *kind | 0x200000);
+					if (i >= 0)
+					{
+						parts[i].dcolour = parts[sampleID].dcolour;
+						parts[i].tmp = parts[sampleID].tmp;
+					}
+				}
+			}
+		}
+	}
+	// * Kill in the same order the general path does, as it affects which
+	//   particle IDs get reused first.
+	std::sort(toKill.begin(), toKill.end());
+	for (auto [pos, i] : toKill)
+	{
+		auto r = pmap[pos / XRES][pos % XRES];
+		if (r == PMAP(i, PT_LIFE) && parts[i].tmp2 <= 0)
+		{
+			kill_part(i);
+		}
+	}
+	return true;
+}
+
 void Simulation::SimulateGoL()
 {
 	auto &builtinGol = SimulationData::builtinGol;
 	CGOL = 0;
+	if (SimulateGoLBitboard())
+	{
+		return;
+	}
 	for (int i = 0; i < parts.active; ++i)
 	{
 		auto &part = parts[i];
@@ -3623,39 +3796,27 @@ void Simulation::UpdateGravityMask()
 	{
 		gravIn.mask[p] = 0;
 	}
-	std::stack<Vec2<int>> toCheck;
-	auto check = [this, &toCheck](Vec2<int> p) {
-		if (!(bmap[p.Y][p.X] == WL_GRAV || gravIn.mask[p]))
+	// * Everything that can be reached from the edges without going through a WL_GRAV is not masked out.
+	auto floodFill = floodFills.Begin();
+	auto matches = [this](int x, int y) {
+		return bmap[y][x] != WL_GRAV;
+	};
+	auto visit = [this](int x1, int x2, int y) {
+		for (auto x = x1; x <= x2; ++x)
 		{
-			gravIn.mask[p] = UINT32_C(0xFFFFFFFF);
-			for (auto o : RectSized<int>({ -1, -1 }, { 3, 3 }))
-			{
-				if ((o.X + o.Y) & 1) // i.e. immediate neighbours but not diagonal ones
-				{
-					auto q = p + o;
-					if (CELLS.OriginRect().Contains(q))
-					{
-						toCheck.push(q);
-					}
-				}
-			}
+			gravIn.mask[{ x, y }] = UINT32_C(0xFFFFFFFF);
 		}
+		return true;
 	};
 	for (auto x = 0; x < CELLS.X; ++x)
 	{
-		check({ x, 0           });
-		check({ x, CELLS.Y - 1 });
+		floodFill->Fill({ x, 0           }, CELLS.OriginRect(), 1, matches, visit);
+		floodFill->Fill({ x, CELLS.Y - 1 }, CELLS.OriginRect(), 1, matches, visit);
 	}
 	for (auto y = 1; y < CELLS.Y - 1; ++y) // corners already checked in the previous loop
 	{
-		check({ 0          , y });
-		check({ CELLS.X - 1, y });
-	}
-	while (!toCheck.empty())
-	{
-		auto p = toCheck.top();
-		toCheck.pop();
-		check(p);
+		floodFill->Fill({ 0          , y }, CELLS.OriginRect(), 1, matches, visit);
+		floodFill->Fill({ CELLS.X - 1, y }, CELLS.OriginRect(), 1, matches, visit);
 	}
 }
 
@@ -3664,17 +3825,7 @@ void Simulation::BeforeSim(bool willUpdate)
 {
 	if (willUpdate)
 	{
-		air->update_air();
-
-		if(aheat_enable)
-			air->update_airh();
-
-		DispatchNewtonianGravity();
-		// gravIn::mass is now potentially garbage, which is ok, we were going to clear it for the frame anyway
-		for (auto p : gravIn.mass.Size().OriginRect())
-		{
-			gravIn.mass[p] = 0.f;
-		}
+		rngFrameKey = CounterRNG::KeyFromState(rng.state());
 
 		if(emp_decor>0)
 			emp_decor -= emp_decor/25+2;
@@ -3693,15 +3844,19 @@ void Simulation::BeforeSim(bool willUpdate)
 	sandcolour_frame = (sandcolour_frame+1)%360;
 	sandcolour = (int)(20.0f*sin((float)(frameCount)*(TPT_PI_FLT/180.0f)));
 
+	if (willUpdate)
+	{
+		beforeSimTasks->Run(!serialBeforeSim && !haveLuaElementCallbacks);
+	}
+	else if (debug_nextToUpdate == 0)
+		RecalcFreeParticles(false);
+
 	if (gravWallChanged)
 	{
 		UpdateGravityMask();
 		gravWallChanged = false;
 	}
 
-	if (debug_nextToUpdate == 0)
-		RecalcFreeParticles(willUpdate);
-
 	if (willUpdate)
 	{
 		// decrease wall conduction, make walls block air and ambient heat
@@ -3846,10 +4001,133 @@ void Simulation::BeforeSim(bool willUpdate)
 		if (!player2.spwn && player2.spawnID >= 0)
 			create_part(-1, (int)parts[player2.spawnID].x, (int)parts[player2.spawnID].y, PT_STKM2);
 
+		if (gridHeat && !legacy_enable)
+		{
+			UpdateGridHeat();
+		}
+
 		// particle update happens right after this function (called separately)
 	}
 }
 
+void Simulation::UpdateGridHeat()
+{
+	if (!heatGrid)
+	{
+		heatGrid = std::make_unique<HeatGrid>();
+	}
+	auto &sd = SimulationData::CRef();
+	auto &hot = sd.hotElements;
+	auto &grid = *heatGrid;
+	grid.Clear();
+	// Only the particle on top of each pixel takes part; the grid has room for one per pixel.
+	auto onTop = [this](int i, int x, int y) {
+		return InBounds(x, y) && ID(pmap[y][x]) == i && TYP(pmap[y][x]) == parts[i].type;
+	};
+	for (int i = 0; i < parts.active; ++i)
+	{
+		auto t = parts[i].type;
+		auto x = int(parts[i].x + 0.5f);
+		auto y = int(parts[i].y + 0.5f);
+		if (!t || !onTop(i, x, y) || sd.IsHeatInsulator(parts[i]))
+		{
+			continue;
+		}
+		auto capacity = hot[t].HeatCapacity;
+		// Double count PIPE/PPIP with contents, as TransitionPhase does
+		if ((t == PT_PIPE || t == PT_PPIP) && parts[i].ctype != 0)
+		{
+			capacity *= 2.0f;
+		}
+		auto conduct = float(hot[t].HeatConduct);
+		if (t == PT_GEL)
+		{
+			conduct *= parts[i].tmp * 2.55f;
+		}
+		grid.temp[y][x] = parts[i].temp;
+		grid.capacity[y][x] = capacity;
+		grid.conduct[y][x] = std::clamp(conduct / 250.0f, 0.0f, 1.0f);
+		if (t == PT_FILT)
+		{
+			grid.heatClass[y][x] = HeatGrid::heatClassFilt;
+		}
+		else if (t == PT_BRAY || t == PT_BIZR || t == PT_BIZRG || (t == PT_HSWC && parts[i].tmp == 1))
+		{
+			grid.heatClass[y][x] = HeatGrid::heatClassFiltOff;
+		}
+	}
+	grid.Step();
+	for (int i = 0; i < parts.active; ++i)
+	{
+		auto t = parts[i].type;
+		auto x = int(parts[i].x + 0.5f);
+		auto y = int(parts[i].y + 0.5f);
+		if (!t || !onTop(i, x, y) || grid.capacity[y][x] == 0.0f)
+		{
+			continue;
+		}
+		auto temp = restrict_flt(grid.temp[y][x], MIN_TEMP, MAX_TEMP);
+		if (std::abs(temp - parts[i].temp) > sleepEpsilon)
+		{
+			WakeBlock(x, y);
+		}
+		parts[i].temp = temp;
+	}
+}
+
+void Simulation::UpdateSleepingRegions()
+{
+	for (int y = 0; y < YCELLS; ++y)
+	{
+		for (int x = 0; x < XCELLS; ++x)
+		{
+			blockActive[y][x] = blockActive[y][x] ||
+			                    bmap[y][x] != sleepBmap[y][x] ||
+			                    emap[y][x] != sleepEmap[y][x] ||
+			                    std::abs(pv[y][x] - sleepPv[y][x]) > sleepEpsilon ||
+			                    std::abs(hv[y][x] - sleepHv[y][x]) > sleepEpsilon ||
+			                    std::abs(vx[y][x]) > sleepEpsilon ||
+			                    std::abs(vy[y][x]) > sleepEpsilon ||
+			                    std::abs(gravOut.forceX[{ x, y }]) > sleepEpsilon ||
+			                    std::abs(gravOut.forceY[{ x, y }]) > sleepEpsilon;
+			sleepBmap[y][x] = bmap[y][x];
+			sleepEmap[y][x] = emap[y][x];
+			sleepPv[y][x] = pv[y][x];
+			sleepHv[y][x] = hv[y][x];
+		}
+	}
+	// * A block only counts as quiet if its neighbours are too, so that activity spreading
+	//   across a block boundary always finds the next block awake.
+	for (int y = 0; y < YCELLS; ++y)
+	{
+		for (int x = 0; x < XCELLS; ++x)
+		{
+			bool active = false;
+			for (int yy = std::max(y - 1, 0); yy <= std::min(y + 1, YCELLS - 1) && !active; ++yy)
+			{
+				for (int xx = std::max(x - 1, 0); xx <= std::min(x + 1, XCELLS - 1) && !active; ++xx)
+				{
+					active = blockActive[yy][xx];
+				}
+			}
+			if (active)
+			{
+				blockQuietFrames[y][x] = 0;
+			}
+			else if (blockQuietFrames[y][x] < sleepFrames)
+			{
+				blockQuietFrames[y][x] += 1;
+			}
+		}
+	}
+	std::fill(&blockActive[0][0], &blockActive[0][0] + NCELL, false);
+}
+
+void Simulation::WakeAllBlocks()
+{
+	std::fill(&blockQuietFrames[0][0], &blockQuietFrames[0][0] + NCELL, 0);
+}
+
 void Simulation::AfterSim()
 {
 	debug_mostRecentlyUpdated = -1;
@@ -3861,6 +4139,11 @@ void Simulation::AfterSim()
 		emp_trigger_count = 0;
 	}
 
+	if (sleepingRegions)
+	{
+		UpdateSleepingRegions();
+	}
+
 	frameCount += 1;
 }
 
@@ -3873,6 +4156,34 @@ Simulation::Simulation()
 
 	//Create and attach air simulation
 	air = std::make_unique<Air>(*this);
+	golBitboard = std::make_unique<GOLBitboard>();
+
+	// The air and gravity chain only touches the air planes and gravIn/gravOut, while the pmap
+	// rebuild only touches parts, pmap and photons, so the two can run side by side. Everything
+	// that comes after them in BeforeSim needs both, and stays serial.
+	beforeSimTasks = std::make_unique<TaskGraph>();
+	auto airTask = beforeSimTasks->Add([this]() {
+		air->update_air();
+	});
+	auto airhTask = beforeSimTasks->Add([this]() {
+		// reads the new air velocities
+		if (aheat_enable)
+			air->update_airh();
+	}, { airTask });
+	beforeSimTasks->Add([this]() {
+		// update_airh reads gravOut, which this replaces
+		DispatchNewtonianGravity();
+		// gravIn::mass is now potentially garbage, which is ok, we were going to clear it for the frame anyway
+		for (auto p : gravIn.mass.Size().OriginRect())
+		{
+			gravIn.mass[p] = 0.f;
+		}
+	}, { airhTask });
+	beforeSimTasks->Add([this]() {
+		// may end up calling ChangeType, which may be implemented in Lua
+		if (debug_nextToUpdate == 0)
+			RecalcFreeParticles(true);
+	}, {}, true);
 
 	player.comm = 0;
 	player2.comm = 0;
@@ -7,7 +7,8 @@
 #include "BuiltinGOL.h"
 #include "MenuSection.h"
 #include "AccessProperty.h"
-#include "CoordStack.h"
+#include "FloodFill.h"
+#include "FrameArena.h"
 #include "common/tpt-rand.h"
 #include "gravity/Gravity.h"
 #include "graphics/RendererFrame.h"
@@ -33,6 +34,9 @@ struct vector2d;
 class Simulation;
 class Renderer;
 class Air;
+class GOLBitboard;
+class HeatGrid;
+class TaskGraph;
 class GameSave;
 
 class Parts
@@ -107,11 +111,32 @@ struct RenderableSimulation
 
 	Parts parts;
 	int pmap[YRES][XRES];
+	// Conservative per-block summary of pmap: if an entry is zero, so is every pmap entry in that
+	// block. Rebuilt along with pmap in RecalcFreeParticles; anything that writes a nonzero value to
+	// pmap must call MarkPmap too, unless it only swaps entries that are both nonzero, as MIX and WARP do.
+	unsigned char pmapOccupied[YCELLS][XCELLS];
 	int photons[YRES][XRES];
+	// Same as pmapOccupied, for photons and MarkPhotons.
+	unsigned char photonsOccupied[YCELLS][XCELLS];
 
 	int aheat_enable = 0;
 
 	bool useLuaCallbacks = false;
+
+	// Bumped every time a particle ID is freed, so that code holding on to IDs while particles
+	// may die, such as the batched Lua element updates, can tell the particle it recorded from
+	// a later one that got the same ID.
+	std::vector<uint32_t> partGenerations = std::vector<uint32_t>(NPART, 0);
+
+	void MarkPmap(int x, int y)
+	{
+		pmapOccupied[y / CELL][x / CELL] = 1;
+	}
+
+	void MarkPhotons(int x, int y)
+	{
+		photonsOccupied[y / CELL][x / CELL] = 1;
+	}
 };
 
 class Simulation : public RenderableSimulation
@@ -121,6 +146,17 @@ public:
 	std::unique_ptr<Air> air;
 
 	RNG rng;
+	// Key for the counter-based streams handed out by FrameRng. Derived from rng's state at the
+	// start of each frame, so it needs no persisting of its own: saves and snapshots that restore
+	// rng's state also reproduce every FrameRng stream.
+	CounterRNG::Key rngFrameKey{};
+
+	// An independent, reproducible random stream for this frame, e.g. one per particle ID or per
+	// tile; draws from it don't depend on the order in which anything else draws.
+	CounterRNG FrameRng(uint32_t substream) const
+	{
+		return CounterRNG(rngFrameKey, frameCount, substream);
+	}
 
 	int replaceModeSelected = 0;
 	int replaceModeFlags = 0;
@@ -138,9 +174,72 @@ public:
 	Particle portalp[CHANNELS][8][80];
 	int wireless[CHANNELS][2];
 
+	// Sleeping regions: when enabled, particles without an Update function are skipped by
+	// UpdateParticles if their CELL block and all blocks around it have seen no activity for
+	// sleepFrames frames. Activity is anything that moves, creates, kills or changes the type of a
+	// particle, a temperature change above sleepEpsilon, air or gravity above sleepEpsilon, or a
+	// wall or emap change; see UpdateSleepingRegions.
+	bool sleepingRegions = false;
+	static constexpr int sleepFrames = 30;
+	static constexpr float sleepEpsilon = 0.01f;
+	unsigned char blockQuietFrames[YCELLS][XCELLS];
+	bool blockActive[YCELLS][XCELLS];
+	float sleepPv[YCELLS][XCELLS];
+	float sleepHv[YCELLS][XCELLS];
+	unsigned char sleepBmap[YCELLS][XCELLS];
+	unsigned char sleepEmap[YCELLS][XCELLS];
+
+	// * These and UpdateSleepingRegions do nothing while sleeping regions are off. Enabling
+	//   them goes through WakeAllBlocks, so whatever went unrecorded in the meantime is harmless.
+	void WakeBlock(int x, int y)
+	{
+		if (sleepingRegions)
+		{
+			blockActive[y / CELL][x / CELL] = true;
+		}
+	}
+
+	void WakeParticle(int i)
+	{
+		if (!sleepingRegions)
+		{
+			return;
+		}
+		auto x = int(parts[i].x + 0.5f);
+		auto y = int(parts[i].y + 0.5f);
+		if (InBounds(x, y))
+		{
+			WakeBlock(x, y);
+		}
+	}
+
+	bool BlockAsleep(int x, int y) const
+	{
+		return sleepingRegions && blockQuietFrames[y / CELL][x / CELL] >= sleepFrames;
+	}
+
 	int CGOL = 0;
 	int GSPEED = 1;
 	unsigned int gol[YRES][XRES][5];
+	std::unique_ptr<GOLBitboard> golBitboard;
+
+	// Grid heat: particle-particle conduction runs as a diffusion step over a per-pixel grid
+	// in BeforeSim instead of stochastically in TransitionPhase. Heat exchange with ambient
+	// heat and temperature transitions still happen in TransitionPhase, every frame rather
+	// than on the frames the stochastic path would conduct.
+	bool gridHeat = false;
+	std::unique_ptr<HeatGrid> heatGrid;
+	void UpdateGridHeat();
+
+	// Runs the independent parts of BeforeSim concurrently; serialBeforeSim runs them one after
+	// the other in their original order instead, for comparing against the threaded schedule.
+	// It also runs the row bands of the air and ambient heat updates one after the other.
+	std::unique_ptr<TaskGraph> beforeSimTasks;
+	bool serialBeforeSim = false;
+	// Set by whoever runs the simulation while element callbacks implemented in Lua exist. The
+	// pmap rebuild may call them, and they may touch the air planes, so BeforeSim then doesn't
+	// run the rebuild alongside the air update.
+	bool haveLuaElementCallbacks = false;
 
 	float fvx[YCELLS][XCELLS];
 	float fvy[YCELLS][XCELLS];
@@ -221,7 +320,10 @@ public:
 	int parts_avg(int ci, int ni, int t);
 	void UpdateParticles(int start, int end); // Dispatches an update to the range [start, end).
 	void SimulateGoL();
+	bool SimulateGoLBitboard();
 	void RecalcFreeParticles(bool do_life_dec);
+	void UpdateSleepingRegions();
+	void WakeAllBlocks();
 	void CheckStacking();
 	void BeforeSim(bool willUpdate);
 	void AfterSim();
@@ -278,7 +380,9 @@ public:
 	const auto &elements() const { return SimulationData::CRef().elements; }
 
 private:
-	CoordStack& getCoordStackSingleton();
+	// Temporaries of Load and the like, which would otherwise hit the heap every time.
+	FrameArena arena;
+	FloodFillStack floodFills;
 
 	void ResetNewtonianGravity(GravityInput newGravIn, GravityOutput newGravOut);
 	void DispatchNewtonianGravity();
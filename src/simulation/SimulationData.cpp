@@ -334,6 +334,40 @@ SimulationData::SimulationData()
 	wtypes = LoadWalls();
 	elements = GetElements();
 	init_can_move();
+	UpdateHotElements();
+}
+
+void SimulationData::UpdateHotElements()
+{
+	for (int t = 0; t < PT_NUM; ++t)
+	{
+		auto &el = elements[t];
+		auto &hot = hotElements[t];
+		hot.Update           = el.Update;
+		hot.Properties       = el.Properties;
+		hot.Advection        = el.Advection;
+		hot.AirDrag          = el.AirDrag;
+		hot.AirLoss          = el.AirLoss;
+		hot.Loss             = el.Loss;
+		hot.Collision        = el.Collision;
+		hot.Gravity          = el.Gravity;
+		hot.NewtonianGravity = el.NewtonianGravity;
+		hot.Diffusion        = el.Diffusion;
+		hot.HotAir           = el.HotAir;
+		hot.HeatCapacity     = el.HeatCapacity;
+		hot.Falldown         = el.Falldown;
+		hot.HeatConduct      = el.HeatConduct;
+		hot.Enabled          = el.Enabled;
+		auto &tr = hotTransitions[t];
+		tr.LowPressure               = el.LowPressure;
+		tr.HighPressure              = el.HighPressure;
+		tr.LowTemperature            = el.LowTemperature;
+		tr.HighTemperature           = el.HighTemperature;
+		tr.LowPressureTransition     = el.LowPressureTransition;
+		tr.HighPressureTransition    = el.HighPressureTransition;
+		tr.LowTemperatureTransition  = el.LowTemperatureTransition;
+		tr.HighTemperatureTransition = el.HighTemperatureTransition;
+	}
 }
 
 bool SimulationData::IsHeatInsulator(const Particle &p) const
@@ -124,10 +124,50 @@ constexpr int NGT_BRAN = 23;
 constexpr auto REPLACE_MODE    = UINT32_C(0x00000001);
 constexpr auto SPECIFIC_DELETE = UINT32_C(0x00000002);
 
+// Copies of the Element fields read for every particle every frame, packed so that
+// one element fits in a cache line. Element itself is several hundred bytes, mostly
+// strings and DefaultProperties, which spreads these fields over the whole table.
+struct alignas(64) HotElement
+{
+	int (*Update)(UPDATE_FUNC_ARGS);
+	unsigned int Properties;
+	float Advection;
+	float AirDrag;
+	float AirLoss;
+	float Loss;
+	float Collision;
+	float Gravity;
+	float NewtonianGravity;
+	float Diffusion;
+	float HotAir;
+	float HeatCapacity;
+	int Falldown;
+	unsigned char HeatConduct;
+	bool Enabled;
+};
+static_assert(sizeof(HotElement) == 64);
+
+// Same idea for TransitionPhase, which is the only reader of these.
+struct alignas(32) HotTransitions
+{
+	float LowPressure;
+	float HighPressure;
+	float LowTemperature;
+	float HighTemperature;
+	int LowPressureTransition;
+	int HighPressureTransition;
+	int LowTemperatureTransition;
+	int HighTemperatureTransition;
+};
+static_assert(sizeof(HotTransitions) == 32);
+
 class SimulationData : public ExplicitSingleton<SimulationData>
 {
 public:
 	std::array<Element, PT_NUM> elements;
+	// Derived from elements by UpdateHotElements, never write these directly.
+	std::array<HotElement, PT_NUM> hotElements;
+	std::array<HotTransitions, PT_NUM> hotTransitions;
 	std::array<gcache_item, PT_NUM> graphicscache;
 	std::vector<wall_type> wtypes;
 	std::vector<menu_section> msections;
@@ -150,6 +190,8 @@ public:
 	void InitElements();
 
 	void init_can_move();
+	// Call after changing any element property that HotElement or HotTransitions mirror.
+	void UpdateHotElements();
 
 	const CustomGOLData *GetCustomGOLByRule(int rule) const;
 	const std::vector<CustomGOLData> &GetCustomGol() const { return customGol; }
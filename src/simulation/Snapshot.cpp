@@ -1,43 +1,92 @@
 #include "Snapshot.h"
 
-uint32_t Snapshot::Hash() const
+namespace
 {
 	// http://www.isthe.com/chongo/tech/comp/fnv/
-	auto hash = UINT32_C(2166136261);
-	auto take = [&hash](const uint8_t *data, size_t size) {
-		for (auto i = 0U; i < size; ++i)
+	class Fnv1a
+	{
+		uint32_t hash = UINT32_C(2166136261);
+
+	public:
+		void Take(const uint8_t *data, size_t size)
 		{
-			hash ^= data[i];
-			hash *= UINT32_C(16777619);
+			for (auto i = 0U; i < size; ++i)
+			{
+				hash ^= data[i];
+				hash *= UINT32_C(16777619);
+			}
+		}
+
+		template<class Thing>
+		void TakeThing(const Thing &thing)
+		{
+			Take(reinterpret_cast<const uint8_t *>(&thing), sizeof(thing));
+		}
+
+		template<class Vec>
+		void TakeVector(const Vec &vec)
+		{
+			Take(reinterpret_cast<const uint8_t *>(vec.data()), vec.size() * sizeof(vec[0]));
+		}
+
+		uint32_t Get() const
+		{
+			return hash;
 		}
 	};
-	auto takeThing = [&take](auto &thing) {
-		take(reinterpret_cast<const uint8_t *>(&thing), sizeof(thing));
-	};
-	auto takeVector = [&take](auto &vec) {
-		take(reinterpret_cast<const uint8_t *>(vec.data()), vec.size() * sizeof(vec[0]));
-	};
-	takeVector(AirPressure);
-	takeVector(AirVelocityX);
-	takeVector(AirVelocityY);
-	takeVector(AmbientHeat);
-	takeVector(Particles);
-	takeVector(GravMass);
-	takeVector(GravMask);
-	takeVector(GravForceX);
-	takeVector(GravForceY);
-	takeVector(BlockMap);
-	takeVector(ElecMap);
-	takeVector(BlockAir);
-	takeVector(BlockAirH);
-	takeVector(FanVelocityX);
-	takeVector(FanVelocityY);
-	takeVector(PortalParticles);
-	takeVector(WirelessData);
-	takeVector(stickmen);
-	takeThing(FrameCount);
-	takeThing(RngState[0]);
-	takeThing(RngState[1]);
+}
+
+uint32_t Snapshot::Hash() const
+{
+	Fnv1a hash;
+	hash.TakeVector(AirPressure);
+	hash.TakeVector(AirVelocityX);
+	hash.TakeVector(AirVelocityY);
+	hash.TakeVector(AirDensity);
+	hash.TakeVector(AmbientHeat);
+	hash.TakeVector(Particles);
+	hash.TakeVector(GravMass);
+	hash.TakeVector(GravMask);
+	hash.TakeVector(GravForceX);
+	hash.TakeVector(GravForceY);
+	hash.TakeVector(BlockMap);
+	hash.TakeVector(ElecMap);
+	hash.TakeVector(BlockAir);
+	hash.TakeVector(BlockAirH);
+	hash.TakeVector(FanVelocityX);
+	hash.TakeVector(FanVelocityY);
+	hash.TakeVector(PortalParticles);
+	hash.TakeVector(WirelessData);
+	hash.TakeVector(stickmen);
+	hash.TakeThing(FrameCount);
+	hash.TakeThing(RngState[0]);
+	hash.TakeThing(RngState[1]);
 	// signs and Authors are excluded on purpose, as they aren't POD and don't have much effect on the simulation.
-	return hash;
+	return hash.Get();
+}
+
+std::vector<Snapshot::SubsystemHash> Snapshot::SubsystemHashes() const
+{
+	std::vector<SubsystemHash> hashes;
+	auto add = [&hashes](const char *name, auto &&...vecs) {
+		Fnv1a hash;
+		(hash.TakeVector(vecs), ...);
+		hashes.push_back({ name, hash.Get() });
+	};
+	add("air", AirPressure, AirVelocityX, AirVelocityY, AirDensity, BlockAir, BlockAirH);
+	add("heat", AmbientHeat);
+	add("particles", Particles);
+	add("gravity", GravMass, GravMask, GravForceX, GravForceY);
+	add("walls", BlockMap, ElecMap, FanVelocityX, FanVelocityY);
+	add("portals", PortalParticles);
+	add("wifi", WirelessData);
+	add("stickmen", stickmen);
+	{
+		Fnv1a hash;
+		hash.TakeThing(FrameCount);
+		hash.TakeThing(RngState[0]);
+		hash.TakeThing(RngState[1]);
+		hashes.push_back({ "rng", hash.Get() });
+	}
+	return hashes;
 }
@@ -43,6 +43,16 @@ public:
 
 	uint32_t Hash() const;
 
+	// Hashes of the fields that belong to each subsystem, using the same hash function
+	// as Hash, so that a mismatch can be narrowed down to the part of the simulation
+	// that caused it. Together these cover the same fields as Hash.
+	struct SubsystemHash
+	{
+		const char *name;
+		uint32_t hash;
+	};
+	std::vector<SubsystemHash> SubsystemHashes() const;
+
 	Bson Authors;
 
 	virtual ~Snapshot() = default;
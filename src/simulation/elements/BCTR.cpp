@@ -318,6 +318,7 @@ static int update(UPDATE_FUNC_ARGS) {
 					parts[i].x = parts[ID(r)].x;
 					parts[i].y = parts[ID(r)].y;
 					pmap[y + ry][x + rx] = PMAP(i, parts[i].type);
+					sim->MarkPmap(x + rx, y + ry);
 					return 1;
 				}
 				// 4 = Reproduce by injecting DNA into other BCTR
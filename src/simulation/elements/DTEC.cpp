@@ -1,4 +1,5 @@
 #include "simulation/ElementCommon.h"
+#include "simulation/SensorRange.h"
 
 static int update(UPDATE_FUNC_ARGS);
 
@@ -84,27 +85,20 @@ static int update(UPDATE_FUNC_ARGS)
 	}
 	bool setFilt = false;
 	int photonWl = 0;
-	for (auto rx=-rd; rx<rd+1; rx++)
-	{
-		for (auto ry=-rd; ry<rd+1; ry++)
+	bool detected = false;
+	// Scanned backwards because the last photon in scan order wins, done once both are found.
+	ScanSensorRange<true>(*sim, x, y, rd, [&](int r) {
+		if (!detected && TYP(r) == parts[i].ctype && (parts[i].ctype != PT_LIFE || parts[i].tmp == parts[ID(r)].ctype || !parts[i].tmp))
+			detected = true;
+		if (!setFilt && (TYP(r) == PT_PHOT || (TYP(r) == PT_BRAY && parts[ID(r)].tmp!=2) || TYP(r) == PT_BIZR || TYP(r) == PT_BIZRG || TYP(r) == PT_BIZRS))
 		{
-			if (x+rx>=0 && y+ry>=0 && x+rx<XRES && y+ry<YRES && (rx || ry))
-			{
-				auto r = pmap[y+ry][x+rx];
-				if(!r)
-					r = sim->photons[y+ry][x+rx];
-				if(!r)
-					continue;
-				if (TYP(r) == parts[i].ctype && (parts[i].ctype != PT_LIFE || parts[i].tmp == parts[ID(r)].ctype || !parts[i].tmp))
-					parts[i].life = 1;
-				if (TYP(r) == PT_PHOT || (TYP(r) == PT_BRAY && parts[ID(r)].tmp!=2) || TYP(r) == PT_BIZR || TYP(r) == PT_BIZRG || TYP(r) == PT_BIZRS)
-				{
-					setFilt = true;
-					photonWl = parts[ID(r)].ctype;
-				}
-			}
+			setFilt = true;
+			photonWl = parts[ID(r)].ctype;
 		}
-	}
+		return detected && setFilt;
+	});
+	if (detected)
+		parts[i].life = 1;
 	if (setFilt)
 	{
 		int nx, ny;
@@ -120,6 +120,8 @@ static int update(UPDATE_FUNC_ARGS) {
 			parts[ID(r)].y = y;
 			pmap[y][x] = r;
 			pmap[y+ry][x+rx] = PMAP(i, parts[i].type);
+			sim->WakeBlock(x, y);
+			sim->WakeBlock(x+rx, y+ry);
 			return 0;
 		}
 	}
@@ -1,4 +1,5 @@
 #include "simulation/ElementCommon.h"
+#include "simulation/SensorRange.h"
 
 static int update(UPDATE_FUNC_ARGS);
 
@@ -86,49 +87,45 @@ static int update(UPDATE_FUNC_ARGS)
 	bool doSerialization = false;
 	bool doDeserialization = false;
 	int life = 0;
-	for (int rx = -rd; rx < rd + 1; rx++)
+	// Serialization and deserialization take the last match in scan order, so they scan backwards.
+	switch (parts[i].tmp)
 	{
-		for (int ry = -rd; ry < rd + 1; ry++)
-		{
-			if (x + rx >= 0 && y + ry >= 0 && x + rx < XRES && y + ry < YRES && (rx || ry))
+	case 1:
+		// .life serialization into FILT
+		doSerialization = ScanSensorRange<true>(*sim, x, y, rd, [&](int r) {
+			if (TYP(r) != PT_LSNS && TYP(r) != PT_FILT && parts[ID(r)].life >= 0)
 			{
-				int r = pmap[y + ry][x + rx];
-				if (!r)
-					r = sim->photons[y + ry][x + rx];
-				if (!r)
-					continue;
-
-				switch (parts[i].tmp)
-				{
-				case 1:
-					// .life serialization into FILT
-					if (TYP(r) != PT_LSNS && TYP(r) != PT_FILT && parts[ID(r)].life >= 0)
-					{
-						doSerialization = true;
-						life = parts[ID(r)].life;
-					}
-					break;
-				case 3:
-					// .life deserialization
-					if (TYP(r) == PT_FILT)
-					{
-						doDeserialization = true;
-						life = parts[ID(r)].ctype;
-					}
-					break;
-				case 2:
-					// Invert mode
-					if (TYP(r) != PT_METL && parts[ID(r)].life <= parts[i].temp - 273.15)
-						parts[i].life = 1;
-					break;
-				default:
-					// Normal mode
-					if (TYP(r) != PT_METL && parts[ID(r)].life > parts[i].temp - 273.15)
-						parts[i].life = 1;
-					break;
-				}
+				life = parts[ID(r)].life;
+				return true;
 			}
-		}
+			return false;
+		});
+		break;
+	case 3:
+		// .life deserialization
+		doDeserialization = ScanSensorRange<true>(*sim, x, y, rd, [&](int r) {
+			if (TYP(r) == PT_FILT)
+			{
+				life = parts[ID(r)].ctype;
+				return true;
+			}
+			return false;
+		});
+		break;
+	case 2:
+		// Invert mode
+		if (ScanSensorRange<false>(*sim, x, y, rd, [&](int r) {
+			return TYP(r) != PT_METL && parts[ID(r)].life <= parts[i].temp - 273.15;
+		}))
+			parts[i].life = 1;
+		break;
+	default:
+		// Normal mode
+		if (ScanSensorRange<false>(*sim, x, y, rd, [&](int r) {
+			return TYP(r) != PT_METL && parts[ID(r)].life > parts[i].temp - 273.15;
+		}))
+			parts[i].life = 1;
+		break;
 	}
 
 	for (int rx = -1; rx <= 1; rx++)
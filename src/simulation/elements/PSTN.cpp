@@ -321,6 +321,9 @@ static int MoveStack(Simulation * sim, int stackX, int stackY, int directionX, i
 				sim->parts[jP].x = float(destX);
 				sim->parts[jP].y = float(destY);
 				sim->pmap[destY][destX] = PMAP(jP, sim->parts[jP].type);
+				sim->MarkPmap(destX, destY);
+				sim->WakeBlock(srcX, srcY);
+				sim->WakeBlock(destX, destY);
 			}
 			return amount;
 		}
@@ -344,6 +347,9 @@ static int MoveStack(Simulation * sim, int stackX, int stackY, int directionX, i
 				sim->parts[jP].x = float(destX);
 				sim->parts[jP].y = float(destY);
 				sim->pmap[destY][destX] = PMAP(jP, sim->parts[jP].type);
+				sim->MarkPmap(destX, destY);
+				sim->WakeBlock(srcX, srcY);
+				sim->WakeBlock(destX, destY);
 			}
 			return possibleMovement;
 		}
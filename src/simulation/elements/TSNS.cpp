@@ -1,4 +1,5 @@
 #include "simulation/ElementCommon.h"
+#include "simulation/SensorRange.h"
 
 static int update(UPDATE_FUNC_ARGS);
 
@@ -83,25 +84,26 @@ static int update(UPDATE_FUNC_ARGS)
 	}
 	bool setFilt = false;
 	int photonWl = 0;
-	for (int rx = -rd; rx <= rd; rx++)
-		for (int ry = -rd; ry <= rd; ry++)
-			if (x + rx >= 0 && y + ry >= 0 && x + rx < XRES && y + ry < YRES && (rx || ry))
-			{
-				int r = pmap[y+ry][x+rx];
-				if (!r)
-					r = sim->photons[y+ry][x+rx];
-				if (!r)
-					continue;
-				if (parts[i].tmp == 0 && TYP(r) != PT_TSNS && TYP(r) != PT_METL && parts[ID(r)].temp > parts[i].temp)
-					parts[i].life = 1;
-				if (parts[i].tmp == 2 && TYP(r) != PT_TSNS && TYP(r) != PT_METL && parts[ID(r)].temp < parts[i].temp)
-					parts[i].life = 1;
-				if (parts[i].tmp == 1 && TYP(r) != PT_TSNS && TYP(r) != PT_FILT)
-				{
-					setFilt = true;
-					photonWl = int(parts[ID(r)].temp);
-				}
-			}
+	if (parts[i].tmp == 0 || parts[i].tmp == 2)
+	{
+		auto detected = ScanSensorRange<false>(*sim, x, y, rd, [&](int r) {
+			if (TYP(r) == PT_TSNS || TYP(r) == PT_METL)
+				return false;
+			return parts[i].tmp == 0 ? parts[ID(r)].temp > parts[i].temp : parts[ID(r)].temp < parts[i].temp;
+		});
+		if (detected)
+			parts[i].life = 1;
+	}
+	else if (parts[i].tmp == 1)
+	{
+		// The last match in scan order wins.
+		setFilt = ScanSensorRange<true>(*sim, x, y, rd, [&](int r) {
+			if (TYP(r) == PT_TSNS || TYP(r) == PT_FILT)
+				return false;
+			photonWl = int(parts[ID(r)].temp);
+			return true;
+		});
+	}
 	if (setFilt)
 	{
 		for (int rx = -1; rx <= 1; rx++)
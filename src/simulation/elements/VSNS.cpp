@@ -1,4 +1,5 @@
 #include "simulation/ElementCommon.h"
+#include "simulation/SensorRange.h"
 
 static int update(UPDATE_FUNC_ARGS);
 
@@ -82,53 +83,56 @@ static int update(UPDATE_FUNC_ARGS)
 	bool doSerialization = false;
 	bool doDeserialization = false;
 	float Vs = 0;
-	for (int rx = -rd; rx < rd + 1; rx++)
-		for (int ry = -rd; ry < rd + 1; ry++)
-			if (x + rx >= 0 && y + ry >= 0 && x + rx < XRES && y + ry < YRES && (rx || ry))
+	auto velocity = [parts](int r) {
+		float Vx = parts[ID(r)].vx;
+		float Vy = parts[ID(r)].vy;
+		float Vm = sqrt(Vx*Vx + Vy*Vy);
+		return Vm;
+	};
+	// Serialization and deserialization take the last match in scan order, so they scan backwards.
+	switch (parts[i].tmp)
+	{
+	case 1:
+		// serialization
+		doSerialization = ScanSensorRange<true>(*sim, x, y, rd, [&](int r) {
+			if (TYP(r) != PT_VSNS && TYP(r) != PT_FILT && !(sim->elements()[TYP(r)].Properties & TYPE_SOLID))
 			{
-				int r = pmap[y + ry][x + rx];
-				if (!r)
-					r = sim->photons[y + ry][x + rx];
-				if (!r)
-					continue;
-				float Vx = parts[ID(r)].vx;
-				float Vy = parts[ID(r)].vy;
-				float Vm = sqrt(Vx*Vx + Vy*Vy);
-
-				switch (parts[i].tmp)
+				Vs = velocity(r);
+				return true;
+			}
+			return false;
+		});
+		break;
+	case 3:
+		// deserialization
+		doDeserialization = ScanSensorRange<true>(*sim, x, y, rd, [&](int r) {
+			if (TYP(r) == PT_FILT)
+			{
+				int vel = parts[ID(r)].ctype - 0x10000000;
+				if (vel >= 0 && vel < MAX_VELOCITY)
 				{
-				case 1:
-					// serialization
-					if (TYP(r) != PT_VSNS && TYP(r) != PT_FILT && !(sim->elements()[TYP(r)].Properties & TYPE_SOLID))
-					{
-						doSerialization = true;
-						Vs = Vm;
-					}
-					break;
-				case 3:
-					// deserialization
-					if (TYP(r) == PT_FILT)
-					{
-						int vel = parts[ID(r)].ctype - 0x10000000;
-						if (vel >= 0 && vel < MAX_VELOCITY)
-						{
-							doDeserialization = true;
-							Vs = float(vel);
-						}
-					}
-					break;
-				case 2:
-					// Invert mode
-					if (!(sim->elements()[TYP(r)].Properties & TYPE_SOLID) && Vm <= parts[i].temp - 273.15)
-						parts[i].life = 1;
-					break;
-				default:
-					// Normal mode
-					if (!(sim->elements()[TYP(r)].Properties & TYPE_SOLID) && Vm > parts[i].temp - 273.15)
-						parts[i].life = 1;
-					break;
+					Vs = float(vel);
+					return true;
 				}
 			}
+			return false;
+		});
+		break;
+	case 2:
+		// Invert mode
+		if (ScanSensorRange<false>(*sim, x, y, rd, [&](int r) {
+			return !(sim->elements()[TYP(r)].Properties & TYPE_SOLID) && velocity(r) <= parts[i].temp - 273.15;
+		}))
+			parts[i].life = 1;
+		break;
+	default:
+		// Normal mode
+		if (ScanSensorRange<false>(*sim, x, y, rd, [&](int r) {
+			return !(sim->elements()[TYP(r)].Properties & TYPE_SOLID) && velocity(r) > parts[i].temp - 273.15;
+		}))
+			parts[i].life = 1;
+		break;
+	}
 
 	for (int rx = -1; rx <= 1; rx++)
 	{
@@ -78,6 +78,8 @@ static int update(UPDATE_FUNC_ARGS)
 				parts[i].life += 4;
 				pmap[y][x] = r;
 				pmap[y + ry][x + rx] = PMAP(i, parts[i].type);
+				sim->WakeBlock(x, y);
+				sim->WakeBlock(x + rx, y + ry);
 				trade = 5;
 			}
 		}
@@ -0,0 +1,98 @@
+#include "Direct.h"
+#include <cmath>
+#include <cstring>
+
+DirectGravity::DirectGravity() :
+	kernelX(kernelSize, 0.f),
+	kernelY(kernelSize, 0.f),
+	fieldX(CELLS, 0.0),
+	fieldY(CELLS, 0.0),
+	mass(CELLS, 0.f),
+	mask(CELLS, UINT32_C(0xFFFFFFFF))
+{
+	// same kernel as the FFT implementation, minus the normalization FFTW needs
+	for (auto p : kernelSize.OriginRect())
+	{
+		auto d = p - (CELLS - Vec2{ 1, 1 });
+		if (d == Vec2{ 0, 0 })
+		{
+			continue;
+		}
+		auto distance = std::hypot(float(d.X), float(d.Y));
+		kernelX[p] = -M_GRAV * d.X / std::pow(distance, 3.f);
+		kernelY[p] = -M_GRAV * d.Y / std::pow(distance, 3.f);
+	}
+}
+
+void DirectGravity::Accumulate(Vec2<int> source, double deltaMass)
+{
+	for (auto y = 0; y < CELLS.Y; ++y)
+	{
+		// the kernel row for this source and output row is contiguous in x, so this vectorizes nicely
+		auto kernelOrigin = Vec2{ CELLS.X - 1 - source.X, y + CELLS.Y - 1 - source.Y };
+		auto *kx = &kernelX[kernelOrigin];
+		auto *ky = &kernelY[kernelOrigin];
+		auto *fx = &fieldX[{ 0, y }];
+		auto *fy = &fieldY[{ 0, y }];
+		for (auto x = 0; x < CELLS.X; ++x)
+		{
+			fx[x] += deltaMass * kx[x];
+			fy[x] += deltaMass * ky[x];
+		}
+	}
+}
+
+bool DirectGravity::Exchange(GravityOutput &gravOut, const GravityInput &gravIn)
+{
+	auto maskChanged = std::memcmp(&mask[{ 0, 0 }], &gravIn.mask[{ 0, 0 }], NCELL * sizeof(uint32_t));
+	sources.clear();
+	changed.clear();
+	for (auto p : CELLS.OriginRect())
+	{
+		auto m = gravIn.mask[p] ? gravIn.mass[p] : 0.f;
+		if (m != 0.f)
+		{
+			if (int(sources.size()) == maxSources)
+			{
+				return false;
+			}
+			sources.push_back(p);
+		}
+		if (m != (mask[p] ? mass[p] : 0.f))
+		{
+			changed.push_back(p);
+		}
+	}
+
+	if (!fieldValid || maskChanged || int(changed.size()) > maxChangedSources)
+	{
+		for (auto p : CELLS.OriginRect())
+		{
+			fieldX[p] = 0.0;
+			fieldY[p] = 0.0;
+		}
+		for (auto p : sources)
+		{
+			Accumulate(p, gravIn.mass[p]);
+		}
+		fieldValid = true;
+	}
+	else
+	{
+		for (auto p : changed)
+		{
+			auto newMass = gravIn.mask[p] ? gravIn.mass[p] : 0.f;
+			auto oldMass = mask[p] ? mass[p] : 0.f;
+			Accumulate(p, double(newMass) - double(oldMass));
+		}
+	}
+	mass = gravIn.mass;
+	mask = gravIn.mask;
+
+	for (auto p : CELLS.OriginRect())
+	{
+		gravOut.forceX[p] = gravIn.mask[p] ? float(fieldX[p]) : 0.f;
+		gravOut.forceY[p] = gravIn.mask[p] ? float(fieldY[p]) : 0.f;
+	}
+	return true;
+}
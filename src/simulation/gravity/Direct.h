@@ -0,0 +1,30 @@
+#pragma once
+#include "GravityData.h"
+#include <vector>
+
+// Direct summation over cells with nonzero mass. Far cheaper than the FFT convolution when only
+// a few dozen cells carry mass, and its results are available in the same frame. Keeps the field
+// of the last input around so that inputs that differ in only a few cells are applied as deltas.
+class DirectGravity
+{
+	static constexpr auto kernelSize = CELLS * 2 - Vec2{ 1, 1 };
+	PlaneAdapter<std::vector<float>, kernelSize.X, kernelSize.Y> kernelX, kernelY;
+	PlaneAdapter<std::vector<double>, CELLS.X, CELLS.Y> fieldX, fieldY;
+	GravityPlane<float> mass;
+	GravityPlane<uint32_t> mask;
+	bool fieldValid = false;
+	std::vector<Vec2<int>> sources;
+	std::vector<Vec2<int>> changed;
+
+	void Accumulate(Vec2<int> source, double deltaMass);
+
+public:
+	// beyond these, the FFT implementation wins
+	static constexpr int maxSources = 64;
+	static constexpr int maxChangedSources = 16;
+
+	DirectGravity();
+
+	// returns false without touching gravOut if gravIn is too dense for direct summation
+	bool Exchange(GravityOutput &gravOut, const GravityInput &gravIn);
+};
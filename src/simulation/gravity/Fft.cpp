@@ -1,11 +1,15 @@
 #include "Gravity.h"
+#include "Direct.h"
 #include "Config.h"
+#include "common/platform/Platform.h"
 #include "prefs/GlobalPrefs.h"
 #include "SimulationConfig.h"
 #include <cstring>
 #include <cmath>
 #include <complex>
 #include <memory>
+#include <vector>
+#include <algorithm>
 #include <fftw3.h>
 #include <thread>
 #include <mutex>
@@ -21,10 +25,17 @@ constexpr auto transSize = (blocks.X / 2 + 1) * blocks.Y;
 // NCELL * 4 is size of data array, scaling needed because FFTW calculates an unnormalized DFT
 constexpr auto scaleFactor = -float(M_GRAV) / (NCELL * 4);
 
+// saved in the data folder; lets FFTW_MEASURE skip the actual measuring on subsequent startups
+constexpr char wisdomFile[] = "fftwf.wisdom";
+
+// only fftwf_execute is thread-safe, everything else that touches the planner must hold this,
+// see https://www.fftw.org/fftw3_doc/Thread-safety.html
+static std::mutex plannerMx;
+
 static_assert(sizeof(std::complex<float>) == sizeof(fftwf_complex));
-struct FftwArrayDeleter        { void operator ()(float               ptr[]) const { fftwf_free(ptr);         } };
-struct FftwComplexArrayDeleter { void operator ()(std::complex<float> ptr[]) const { fftwf_free(ptr);         } };
-struct FftwPlanDeleter         { void operator ()(fftwf_plan          ptr  ) const { fftwf_destroy_plan(ptr); } };
+struct FftwArrayDeleter        { void operator ()(float               ptr[]) const {                                  fftwf_free(ptr);         } };
+struct FftwComplexArrayDeleter { void operator ()(std::complex<float> ptr[]) const {                                  fftwf_free(ptr);         } };
+struct FftwPlanDeleter         { void operator ()(fftwf_plan          ptr  ) const { std::unique_lock lk(plannerMx); fftwf_destroy_plan(ptr); } };
 using  FftwArrayPtr        = std::unique_ptr<float                              [], FftwArrayDeleter       >;
 using  FftwComplexArrayPtr = std::unique_ptr<std::complex<float>                [], FftwComplexArrayDeleter>;
 using  FftwPlanPtr         = std::unique_ptr<std::remove_pointer<fftwf_plan>::type, FftwPlanDeleter        >;
@@ -42,9 +53,12 @@ struct GravityImpl : public Gravity
 	FftwArrayPtr                            massBig , forceXBig , forceYBig ;
 	FftwComplexArrayPtr kernelXT, kernelYT, massBigT, forceXBigT, forceYBigT;
 	FftwPlanPtr massForward, forceXInverse, forceYInverse;
-	bool initDone = false;
+	bool planMeasure;
+
+	DirectGravity direct;
 
 	std::thread thr;
+	bool initDone = false;
 	bool working = false;
 	bool shouldStop = false;
 	std::mutex stateMx;
@@ -53,7 +67,9 @@ struct GravityImpl : public Gravity
 	GravityInput gravIn;
 	GravityOutput gravOut;
 	bool copyGravOut = false;
+	bool forceRecalcPending = false;
 
+	GravityImpl();
 	~GravityImpl();
 
 	void Init();
@@ -61,15 +77,51 @@ struct GravityImpl : public Gravity
 	void Wait();
 	void Stop();
 	void Dispatch();
+	bool InitDone();
 };
 
+GravityImpl::GravityImpl()
+{
+	// prefs are not thread-safe, read them here rather than in Init
+	planMeasure = GlobalPrefs::Ref().Get("FftwPlanMeasure", FFTW_PLAN_MEASURE);
+	thr = std::thread([this]() {
+		Init();
+		{
+			std::unique_lock lk(stateMx);
+			initDone = true;
+		}
+		while (true)
+		{
+			{
+				std::unique_lock lk(stateMx);
+				stateCv.wait(lk, [this]() {
+					return working || shouldStop;
+				});
+				if (shouldStop)
+				{
+					break;
+				}
+			}
+			Work();
+			{
+				std::unique_lock lk(stateMx);
+				working = false;
+			}
+			stateCv.notify_one();
+		}
+	});
+}
+
 GravityImpl::~GravityImpl()
 {
-	if (initDone)
-	{
-		Wait();
-		Stop();
-	}
+	Wait();
+	Stop();
+}
+
+bool GravityImpl::InitDone()
+{
+	std::unique_lock lk(stateMx);
+	return initDone;
 }
 
 void GravityImpl::Dispatch()
@@ -133,10 +185,40 @@ void GravityImpl::Work()
 	}
 }
 
+static void ImportWisdom()
+{
+	if (!Platform::FileExists(wisdomFile))
+	{
+		return;
+	}
+	std::vector<char> wisdom;
+	if (Platform::ReadFile(wisdom, wisdomFile))
+	{
+		wisdom.push_back(0);
+		// failure is not fatal, the planner simply measures again
+		fftwf_import_wisdom_from_string(wisdom.data());
+	}
+}
+
+static void ExportWisdom()
+{
+	std::vector<char> wisdom;
+	fftwf_export_wisdom([](char c, void *data) {
+		reinterpret_cast<std::vector<char> *>(data)->push_back(c);
+	}, &wisdom);
+	std::vector<char> oldWisdom;
+	if (Platform::FileExists(wisdomFile) && Platform::ReadFile(oldWisdom, wisdomFile) && oldWisdom == wisdom)
+	{
+		return;
+	}
+	Platform::WriteFile(wisdom, wisdomFile);
+}
+
+// runs on the worker thread: planning with FFTW_MEASURE takes a noticeable amount of time, and
+// Gravity::Exchange just doesn't dispatch anything until this is done
 void GravityImpl::Init()
 {
 	//select best algorithm, could use FFTW_PATIENT or FFTW_EXHAUSTIVE but that increases the time taken to plan, and I don't see much increase in execution speed
-	auto planMeasure = GlobalPrefs::Ref().Get("FftwPlanMeasure", FFTW_PLAN_MEASURE);
 	auto fftwPlanFlags = planMeasure ? FFTW_MEASURE : FFTW_ESTIMATE;
 
 	//use fftw malloc function to ensure arrays are aligned, to get better performance
@@ -149,14 +231,26 @@ void GravityImpl::Init()
 	forceXBigT = FftwComplexArray(transSize);
 	forceYBigT = FftwComplexArray(transSize);
 
-	massForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, massBig.get(), reinterpret_cast<fftwf_complex *>(massBigT.get()), fftwPlanFlags));
-	forceXInverse = FftwPlanPtr(fftwf_plan_dft_c2r_2d(blocks.Y, blocks.X, reinterpret_cast<fftwf_complex *>(forceXBigT.get()), forceXBig.get(), fftwPlanFlags));
-	forceYInverse = FftwPlanPtr(fftwf_plan_dft_c2r_2d(blocks.Y, blocks.X, reinterpret_cast<fftwf_complex *>(forceYBigT.get()), forceYBig.get(), fftwPlanFlags));
-
 	auto kernelXRaw = FftwArray(blocks.X * blocks.Y);
 	auto kernelYRaw = FftwArray(blocks.X * blocks.Y);
-	auto kernelXForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, kernelXRaw.get(), reinterpret_cast<fftwf_complex *>(kernelXT.get()), fftwPlanFlags));
-	auto kernelYForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, kernelYRaw.get(), reinterpret_cast<fftwf_complex *>(kernelYT.get()), fftwPlanFlags));
+	FftwPlanPtr kernelXForward, kernelYForward;
+	{
+		std::unique_lock lk(plannerMx);
+		if (planMeasure && ALLOW_DATA_FOLDER)
+		{
+			ImportWisdom();
+		}
+		massForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, massBig.get(), reinterpret_cast<fftwf_complex *>(massBigT.get()), fftwPlanFlags));
+		forceXInverse = FftwPlanPtr(fftwf_plan_dft_c2r_2d(blocks.Y, blocks.X, reinterpret_cast<fftwf_complex *>(forceXBigT.get()), forceXBig.get(), fftwPlanFlags));
+		forceYInverse = FftwPlanPtr(fftwf_plan_dft_c2r_2d(blocks.Y, blocks.X, reinterpret_cast<fftwf_complex *>(forceYBigT.get()), forceYBig.get(), fftwPlanFlags));
+		kernelXForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, kernelXRaw.get(), reinterpret_cast<fftwf_complex *>(kernelXT.get()), fftwPlanFlags));
+		kernelYForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, kernelYRaw.get(), reinterpret_cast<fftwf_complex *>(kernelYT.get()), fftwPlanFlags));
+		if (planMeasure && ALLOW_DATA_FOLDER)
+		{
+			ExportWisdom();
+		}
+	}
+
 	PlaneAdapter<PlaneBase<float>, blocks.X, blocks.Y> kernelX(blocks, std::in_place, kernelXRaw.get());
 	PlaneAdapter<PlaneBase<float>, blocks.X, blocks.Y> kernelY(blocks, std::in_place, kernelYRaw.get());
 	//calculate velocity map caused by a point mass
@@ -182,41 +276,32 @@ void GravityImpl::Init()
 
 	//clear padded gravmap
 	std::fill(massBig.get(), massBig.get() + blocks.X * blocks.Y, 0.f);
-
-	thr = std::thread([this]() {
-		while (true)
-		{
-			{
-				std::unique_lock lk(stateMx);
-				stateCv.wait(lk, [this]() {
-					return working || shouldStop;
-				});
-				if (shouldStop)
-				{
-					break;
-				}
-			}
-			Work();
-			{
-				std::unique_lock lk(stateMx);
-				working = false;
-			}
-			stateCv.notify_one();
-		}
-	});
 }
 
 void Gravity::Exchange(GravityOutput &gravOut, GravityInput &gravIn, bool forceRecalc)
 {
 	auto *fftGravity = static_cast<GravityImpl *>(this);
 
-	// lazy init
-	if (!fftGravity->initDone)
+	if (forceRecalc)
 	{
-		// this takes a noticeable amount of time
-		// TODO: hide the wait somehow
-		fftGravity->Init();
-		fftGravity->initDone = true;
+		fftGravity->forceRecalcPending = true;
+	}
+
+	// sparse inputs are handled right here, in the same frame
+	if (fftGravity->direct.Exchange(gravOut, gravIn))
+	{
+		// anything the worker thread is still working on is for an older input, drop it
+		fftGravity->copyGravOut = false;
+		// the worker thread hasn't seen this input; make sure it does once the input becomes too dense
+		fftGravity->forceRecalcPending = true;
+		return;
+	}
+
+	// no Newtonian forces until the worker thread is done planning; gravOut stays as it is,
+	// which is all zeroes for a freshly enabled gravity
+	if (!fftGravity->InitDone())
+	{
+		return;
 	}
 
 	fftGravity->Wait();
@@ -229,23 +314,76 @@ void Gravity::Exchange(GravityOutput &gravOut, GravityInput &gravIn, bool forceR
 	}
 
 	// pass input (but same input => same output)
-	if (forceRecalc ||
+	if (fftGravity->forceRecalcPending ||
 	    std::memcmp(&fftGravity->gravIn.mass[{ 0, 0 }], &gravIn.mass[{ 0, 0 }], NCELL * sizeof(float)) ||
 	    std::memcmp(&fftGravity->gravIn.mask[{ 0, 0 }], &gravIn.mask[{ 0, 0 }], NCELL * sizeof(float)))
 	{
 		fftGravity->copyGravOut = true;
+		fftGravity->forceRecalcPending = false;
 		std::swap(gravIn.mass, fftGravity->gravIn.mass);
 		fftGravity->gravIn.mask = gravIn.mask;
 		fftGravity->Dispatch();
 	}
 }
 
+// planning can't be interrupted and waiting for it would stall the caller, so objects deleted
+// while their worker thread is still planning are kept here until it's done; they are deleted,
+// and their worker threads joined, the next time a Gravity is created or deleted, or at the
+// latest when this goes away at exit, which is before plannerMx and the like go away
+class RetiredGravity
+{
+	std::mutex mx;
+	std::vector<std::unique_ptr<GravityImpl>> impls;
+
+public:
+	~RetiredGravity()
+	{
+		// may well wait for planning to finish, but the worker thread must not outlive main
+		impls.clear();
+	}
+
+	void Add(GravityImpl *fftGravity)
+	{
+		std::unique_lock lk(mx);
+		impls.emplace_back(fftGravity);
+	}
+
+	void Reap()
+	{
+		std::vector<std::unique_ptr<GravityImpl>> done;
+		{
+			std::unique_lock lk(mx);
+			auto it = std::stable_partition(impls.begin(), impls.end(), [](auto &impl) {
+				return !impl->InitDone();
+			});
+			done.insert(done.end(), std::make_move_iterator(it), std::make_move_iterator(impls.end()));
+			impls.erase(it, impls.end());
+		}
+		// done goes away here, outside the lock
+	}
+
+	static RetiredGravity &Ref()
+	{
+		static RetiredGravity retired;
+		return retired;
+	}
+};
+
 GravityPtr Gravity::Create()
 {
+	RetiredGravity::Ref().Reap();
 	return GravityPtr(new GravityImpl());
 }
 
 void GravityDeleter::operator ()(Gravity *ptr) const
 {
-	delete static_cast<GravityImpl *>(ptr);
+	auto *fftGravity = static_cast<GravityImpl *>(ptr);
+	auto &retired = RetiredGravity::Ref();
+	retired.Reap();
+	if (!fftGravity->InitDone())
+	{
+		retired.Add(fftGravity);
+		return;
+	}
+	delete fftGravity;
 }